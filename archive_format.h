@@ -0,0 +1,52 @@
+/**
+ * @file archive_format.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds the layout of the packed bracket archive format.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef ARCHIVE_FORMAT
+#define ARCHIVE_FORMAT
+
+#include <cstdint>
+
+/**
+ * LAYOUT (pages of ARCHIVE_PAGE_SIZE bytes, in the byte order of the machine
+ * that wrote the archive):
+ *   page 0                             archive_header, rest of page unused
+ *   pages 1 to num_pages - 1           saves and the index, each starting on a
+ *                                      page and taking whole pages
+ * Each save is a binary save (see saved_format.h). The index is num_entries
+ * archive_entry records, each followed by name_length bytes of its name (not
+ * null terminated), and its checksum is a 64-bit FNV-1a hash
+ * (utils::checksum()) of the whole index. Pages held by neither a save nor the
+ * index are free. The index is only ever written to free pages, and the header
+ * is written last to point at it once the index and saves are synced to disk,
+ * so an archive always holds the index and saves of the last commit even if
+ * the program stops in the middle of one.
+ */
+static const char          ARCHIVE_MAGIC[4]  = {'P', 'B', 'R', 'A'};
+static const std::uint32_t ARCHIVE_VERSION   = 1;
+static const std::uint32_t ARCHIVE_PAGE_SIZE = 4096;
+
+struct archive_header
+{
+    char          magic[4];         // ARCHIVE_MAGIC
+    std::uint32_t version;          // ARCHIVE_VERSION
+    std::uint32_t page_size;        // ARCHIVE_PAGE_SIZE
+    std::uint32_t num_entries;      // Brackets in the index
+    std::uint64_t num_pages;        // Pages in the archive, header included
+    std::uint64_t index_page;       // First page of the index (0 if empty)
+    std::uint64_t index_bytes;      // Size of the index
+    std::uint64_t index_checksum;   // Hash of the index
+};
+
+struct archive_entry
+{
+    std::uint64_t first_page;       // First page of the save
+    std::uint64_t save_bytes;       // Size of the save
+    std::uint32_t num_teams;        // Teams in the bracket
+    std::uint32_t name_length;      // Length of the name after this record
+};
+
+#endif
@@ -0,0 +1,396 @@
+/**
+ * @file archive_store.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the archive_store class, a bracket
+ *        store that packs many brackets into one archive file.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "archive_store.h"
+using namespace std;
+
+/**
+ * @brief Param. constructor that opens the archive and reads its index, or
+ *        creates an empty archive if there is no file (or an empty one)
+ *
+ * @param _file_name is the archive file
+ * @throws invalid_argument if the archive can't be created or read, or is
+ *         corrupt
+ */
+archive_store::archive_store(const string & _file_name) : file_name(_file_name),
+    end_page(1), dirty(false)
+{
+    error_code err;
+
+    if (!filesystem::exists(file_name, err) || filesystem::file_size(file_name, err) == 0)
+    {
+        ofstream create(file_name, ios::out | ios::trunc | ios::binary);
+        string   page(ARCHIVE_PAGE_SIZE, '\0');     // Header page
+
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+        header.version   = ARCHIVE_VERSION;
+        header.page_size = ARCHIVE_PAGE_SIZE;
+        header.num_pages = 1;
+        header.index_checksum = checksum(nullptr, 0);
+        memcpy(&page[0], &header, sizeof(header));
+        create.write(page.data(), page.size());
+        create.close();
+        if (create.fail())
+            throw invalid_argument("Archive could not be created.");
+    }
+
+    file.open(file_name, ios::in | ios::out | ios::binary);
+    if (!file)
+        throw invalid_argument("ERROR: file could not be read");
+    read_index();
+}
+
+
+// Destructor, commits what hasn't been
+archive_store::~archive_store()
+{
+    try {
+        commit();
+    } catch (...) {}
+}
+
+
+/**
+ * @brief gets the names of every bracket, sorted
+ *
+ * @param _names is a std::vector<std::string> to fill (must be empty)
+ * @throws invalid_argument if the vector isn't empty or there are no brackets
+ */
+void archive_store::get_files(vector<string> & _names)
+{
+    if (_names.size() > 0)
+        throw invalid_argument("Vector argument is non-empty");
+    if (entries.empty())
+        throw invalid_argument("No brackets saved yet.");
+    _names.reserve(entries.size());
+    for (const auto & entry : entries)
+        _names.push_back(entry.first);
+}
+
+
+bool archive_store::contains(const string & _name)
+{
+    return entries.count(_name) > 0;
+}
+
+
+int archive_store::num_teams(const string & _name)
+{
+    auto found = entries.find(_name);
+    return found == entries.end() ? 0 : found->second.num_teams;
+}
+
+
+/**
+ * @brief loads a bracket from its save, read in one read from its pages
+ *
+ * @param _name is the name of the bracket
+ * @param _target is the bracket to load into
+ * @throws invalid_argument if there is no such bracket or its save is corrupt
+ */
+void archive_store::load(const string & _name, bracket & _target)
+{
+    auto found = entries.find(_name);
+
+    if (found == entries.end())
+        throw invalid_argument("ERROR: file does not exist");
+
+    buffer.resize(found->second.save_bytes);
+    file.seekg(found->second.first_page * ARCHIVE_PAGE_SIZE);
+    file.read(&buffer[0], buffer.size());
+    if (!file)
+    {
+        file.clear();
+        throw invalid_argument("Archive is corrupt (file cut short)");
+    }
+    _target.fill_bracket(buffer.data(), buffer.size());
+    _target.mark_saved();
+}
+
+
+/**
+ * @brief saves a bracket to free pages, replacing any bracket of the same
+ *        name. The old save's pages are freed at the next commit.
+ *
+ * @param _name is the name of the bracket
+ * @param _source is the bracket to save
+ * @throws invalid_argument if the save couldn't be written
+ */
+void archive_store::save(const string & _name, bracket & _source)
+{
+    archive_entry entry;    // Where the save is
+
+    _source.write_binary(buffer);
+    entry.first_page  = allocate(pages_for(buffer.size()));
+    entry.save_bytes  = buffer.size();
+    entry.num_teams   = _source.num_teams();
+    entry.name_length = _name.size();
+    write_pages(entry.first_page, buffer);
+
+    auto found = entries.find(_name);
+    if (found != entries.end())
+    {
+        released.emplace_back(found->second.first_page, pages_for(found->second.save_bytes));
+        found->second = entry;
+    }
+    else
+        entries.emplace(_name, entry);
+    dirty = true;
+    _source.mark_saved();
+}
+
+
+/**
+ * @brief removes a bracket from the index. Its pages are freed at the next
+ *        commit.
+ *
+ * @param _name is the name of the bracket
+ * @return true if the bracket was removed
+ * @return false if there was no such bracket
+ */
+bool archive_store::remove(const string & _name)
+{
+    auto found = entries.find(_name);
+
+    if (found == entries.end())
+        return false;
+    released.emplace_back(found->second.first_page, pages_for(found->second.save_bytes));
+    entries.erase(found);
+    dirty = true;
+    return true;
+}
+
+
+/**
+ * @brief makes every save and remove since the last commit last. The index is
+ *        written to free pages and synced to disk with the saves, and only
+ *        then is the header written (and synced) to point at it, so until then
+ *        the last commit's index is the one read. After, the pages of the old
+ *        index and of removed or replaced saves are free.
+ *
+ * @throws invalid_argument if the archive couldn't be written
+ */
+void archive_store::commit()
+{
+    archive_header next = header;   // Header of this commit
+    string         index;           // Entries of the index, with their names
+
+    if (!dirty)
+        return;
+
+    for (const auto & entry : entries)
+    {
+        index.append((const char *)&entry.second, sizeof(entry.second));
+        index.append(entry.first);
+    }
+    next.num_entries    = entries.size();
+    next.index_bytes    = index.size();
+    next.index_checksum = checksum(index.data(), index.size());
+    next.index_page     = index.empty() ? 0 : allocate(pages_for(index.size()));
+    if (!index.empty())
+        write_pages(next.index_page, index);
+    next.num_pages      = end_page;
+
+    // Header goes last, once everything it points at is on disk
+    file.flush();
+    if (!file || !sync_file(file_name))
+    {
+        file.clear();
+        if (!index.empty())
+            release(next.index_page, pages_for(index.size()));
+        throw invalid_argument("Archive could not be written.");
+    }
+    file.seekp(0);
+    file.write((const char *)&next, sizeof(next));
+    file.flush();
+    if (!file || !sync_file(file_name))
+    {
+        // The header may be on disk or not, so the new index's pages stay
+        // used until the archive is opened again
+        file.clear();
+        throw invalid_argument("Archive could not be written.");
+    }
+
+    if (header.index_bytes > 0)
+        release(header.index_page, pages_for(header.index_bytes));
+    for (const pair<uint64_t, uint64_t> & pages : released)
+        release(pages.first, pages.second);
+    released.clear();
+    header = next;
+    dirty  = false;
+}
+
+
+uint64_t archive_store::num_pages() const { return end_page; }
+
+
+uint64_t archive_store::free_pages() const
+{
+    uint64_t pages = 0;
+
+    for (const auto & run : free_list)
+        pages += run.second;
+    return pages;
+}
+
+
+/**
+ * @brief private helper that reads the header and index of the last commit,
+ *        and frees every page between the saves and the index
+ *
+ * @throws invalid_argument if the archive is from an unknown version, or its
+ *         index is cut short, corrupt, or points outside the archive
+ */
+void archive_store::read_index()
+{
+    vector<pair<uint64_t, uint64_t>> used;  // Runs of pages in use, sorted
+    size_t                           at = 0;    // Offset in the index
+
+    file.seekg(0);
+    file.read((char *)&header, sizeof(header));
+    if (!file || memcmp(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 ||
+        header.version != ARCHIVE_VERSION || header.page_size != ARCHIVE_PAGE_SIZE)
+        throw invalid_argument("Archive is from an unknown version");
+    if (header.num_pages < 1 || (header.index_bytes > 0 && (header.index_page < 1 ||
+        header.index_page + pages_for(header.index_bytes) > header.num_pages)))
+        throw invalid_argument("Archive is corrupt (bad index)");
+
+    buffer.resize(header.index_bytes);
+    file.seekg(header.index_page * ARCHIVE_PAGE_SIZE);
+    file.read(&buffer[0], buffer.size());
+    if (!file)
+        throw invalid_argument("Archive is corrupt (file cut short)");
+    if (checksum(buffer.data(), buffer.size()) != header.index_checksum)
+        throw invalid_argument("Archive is corrupt (checksum mismatch)");
+
+    for (uint32_t i = 0; i < header.num_entries; ++i)
+    {
+        archive_entry entry;
+        if (buffer.size() - at < sizeof(entry))
+            throw invalid_argument("Archive is corrupt (bad index)");
+        memcpy(&entry, buffer.data() + at, sizeof(entry));
+        at += sizeof(entry);
+        if (buffer.size() - at < entry.name_length || entry.first_page < 1 ||
+            entry.first_page + pages_for(entry.save_bytes) > header.num_pages)
+            throw invalid_argument("Archive is corrupt (bad index)");
+        entries.emplace(string(buffer.data() + at, entry.name_length), entry);
+        at += entry.name_length;
+        used.emplace_back(entry.first_page, pages_for(entry.save_bytes));
+    }
+    if (header.index_bytes > 0)
+        used.emplace_back(header.index_page, pages_for(header.index_bytes));
+    end_page = header.num_pages;
+
+    // Free pages are the gaps between the runs in use
+    sort(used.begin(), used.end());
+    uint64_t page = 1;
+    for (const pair<uint64_t, uint64_t> & run : used)
+    {
+        if (run.first < page)
+            throw invalid_argument("Archive is corrupt (saves overlap)");
+        if (run.first > page)
+            free_list.emplace(page, run.first - page);
+        page = run.first + run.second;
+    }
+    if (page < end_page)
+        free_list.emplace(page, end_page - page);
+}
+
+
+/**
+ * @brief private helper that finds pages for a save or index: the first free
+ *        run with room, or else new pages at the end of the archive
+ *
+ * @param _pages is the number of pages needed
+ * @return uint64_t: the first of the pages
+ */
+uint64_t archive_store::allocate(uint64_t _pages)
+{
+    uint64_t first;     // First page given out
+
+    for (auto run = free_list.begin(); run != free_list.end(); ++run)
+    {
+        if (run->second < _pages)
+            continue;
+        first = run->first;
+        if (run->second > _pages)
+            free_list.emplace(first + _pages, run->second - _pages);
+        free_list.erase(run);
+        return first;
+    }
+
+    first     = end_page;
+    end_page += _pages;
+    return first;
+}
+
+
+/**
+ * @brief private helper that frees a run of pages, merging it with the free
+ *        runs on either side
+ *
+ * @param _first_page is the first page of the run
+ * @param _pages is the number of pages in the run
+ */
+void archive_store::release(uint64_t _first_page, uint64_t _pages)
+{
+    auto next = free_list.lower_bound(_first_page);
+
+    if (next != free_list.end() && _first_page + _pages == next->first)
+    {
+        _pages += next->second;
+        next    = free_list.erase(next);
+    }
+    if (next != free_list.begin())
+    {
+        auto before = prev(next);
+        if (before->first + before->second == _first_page)
+        {
+            before->second += _pages;
+            return;
+        }
+    }
+    free_list.emplace(_first_page, _pages);
+}
+
+
+/**
+ * @brief private helper that writes bytes at the start of a run of pages. The
+ *        last pages of the archive are padded out to a whole page, so the
+ *        next run at the end starts on a page.
+ *
+ * @param _first_page is the first page to write
+ * @param _bytes is the bytes to write
+ * @throws invalid_argument if the bytes couldn't be written
+ */
+void archive_store::write_pages(uint64_t _first_page, const string & _bytes)
+{
+    uint64_t pages = pages_for(_bytes.size());  // Pages written
+
+    file.seekp(_first_page * ARCHIVE_PAGE_SIZE);
+    file.write(_bytes.data(), _bytes.size());
+    if (_first_page + pages == end_page && _bytes.size() % ARCHIVE_PAGE_SIZE != 0)
+    {
+        string padding(ARCHIVE_PAGE_SIZE - _bytes.size() % ARCHIVE_PAGE_SIZE, '\0');
+        file.write(padding.data(), padding.size());
+    }
+    if (!file)
+    {
+        file.clear();
+        release(_first_page, pages);
+        throw invalid_argument("Archive could not be written.");
+    }
+}
+
+
+// private helper that gives the whole pages needed to hold a number of bytes
+uint64_t archive_store::pages_for(uint64_t _bytes)
+{
+    return (_bytes + ARCHIVE_PAGE_SIZE - 1) / ARCHIVE_PAGE_SIZE;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file archive_store.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the archive_store class, a bracket store that
+ *        packs many brackets into one archive file.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef ARCHIVE_STORE
+#define ARCHIVE_STORE
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+#include <cstdint>
+#include "bracket_store.h"
+#include "archive_format.h"
+#include "saved_format.h"
+#include "utils.h"
+
+/**
+ * @brief Keeps many brackets in one archive file (see archive_format.h): each
+ *        bracket's binary save on whole pages, and an index of every name and
+ *        where its save is at the end of the last commit. Opening the archive
+ *        reads the header and index in two reads, and loading a bracket is one
+ *        more read at an offset, so there is only one file to open however
+ *        many brackets it holds. A save goes to free pages, the first run of
+ *        them that fits, or the end of the archive. Pages of removed or
+ *        replaced saves are freed at the next commit, once the index no longer
+ *        points at them; the free list isn't stored, it is the pages no save
+ *        or index holds when the archive is opened. commit() writes the index
+ *        to free pages and syncs it to disk, then writes and syncs the header,
+ *        so saves since the last commit are lost if the program or machine
+ *        stops first, but never the commit before.
+ *        The archive commits when it is destroyed.
+ */
+class archive_store : public bracket_store, protected utils
+{
+    public:
+        // Param. constructor, creates the archive if it doesn't exist
+        archive_store(const std::string & _file_name);
+        archive_store(const archive_store &) = delete;
+        ~archive_store();                       // Destructor
+
+        archive_store & operator = (const archive_store &) = delete;
+
+        void get_files(std::vector<std::string> & _names) override;
+        bool contains(const std::string & _name) override;
+        int  num_teams(const std::string & _name) override;
+        void load(const std::string & _name, bracket & _target) override;
+        void save(const std::string & _name, bracket & _source) override;
+        bool remove(const std::string & _name) override;
+        void commit() override;
+
+        std::uint64_t num_pages() const;        // Pages in the archive
+        std::uint64_t free_pages() const;       // Pages free to reuse
+
+    private:
+        std::string    file_name;   // Archive file
+        std::fstream   file;        // Archive, open to read and write
+        archive_header header;      // Header of the last commit
+        std::map<std::string, archive_entry> entries;  // Index by name
+        // Free runs of pages, first page to number of pages
+        std::map<std::uint64_t, std::uint64_t> free_list;
+        // Runs of pages to free at the next commit
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> released;
+        std::uint64_t  end_page;    // Pages in the file, including new saves
+        bool           dirty;       // If anything changed since the commit
+        std::string    buffer;      // Bytes of the last save read or written
+
+        void read_index();
+        std::uint64_t allocate(std::uint64_t _pages);
+        void release(std::uint64_t _first_page, std::uint64_t _pages);
+        void write_pages(std::uint64_t _first_page, const std::string & _bytes);
+        static std::uint64_t pages_for(std::uint64_t _bytes);
+};
+
+#endif
@@ -0,0 +1,753 @@
+/**
+ * @file bracket_bench.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Microbenchmarks for the bracket core. Times loading, reading the Final
+ *        Four out of a save, saving, saving to and loading from the memory and
+ *        archive bracket stores, drawing, advancing, seeding, copying,
+ *        forking and validating brackets of 2^1 to 2^20 teams, counts the heap
+ *        allocations each operation makes, and reports everything as JSON so
+ *        runs can be compared over time. It also checks that rebuilding a
+ *        bracket from a file reuses its memory (see check_rebuild()), that a
+ *        bracket is built in a few allocations and forked in a few bytes (see
+ *        check_sharing()), and that the seeded matchup order is the one the
+ *        bracket has always used (see check_seed_order()), and exits with 2 if
+ *        a check fails.
+ *
+ *        Build from the repository root with every source but main.cpp:
+ *        g++ -std=c++17 -O2 -pthread -I. bench/bracket_bench.cpp
+ *            bench/workload.cpp <sources>
+ *
+ *        Options:
+ *        --min-time MS   time each case for at least MS ms (default 200)
+ *        --max-teams N   largest bracket to time, a power of two (default 2^20)
+ *        --filter NAME   only time cases whose name holds NAME
+ *        --out FILE      write the report to FILE instead of stdout
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <optional>
+#include <cstdlib>
+#include <cmath>
+#include <new>
+#include <filesystem>
+#include "bracket.h"
+#include "bracket_creator.h"
+#include "saved_reader.h"
+#include "memory_store.h"
+#include "archive_store.h"
+#include "workload.h"
+using namespace std;
+
+// Heap allocations made and freed so far, counted by the operator new and
+// delete below
+static atomic<long long> alloc_count(0);
+static atomic<long long> alloc_bytes(0);
+static atomic<long long> free_count(0);
+
+void * operator new(size_t _size)
+{
+    alloc_count.fetch_add(1, memory_order_relaxed);
+    alloc_bytes.fetch_add(_size, memory_order_relaxed);
+    if (void * memory = malloc(_size ? _size : 1))
+        return memory;
+    throw bad_alloc();
+}
+// The array forms of new and delete forward to these
+void operator delete(void * _memory) noexcept
+{
+    if (_memory)
+        free_count.fetch_add(1, memory_order_relaxed);
+    free(_memory);
+}
+void operator delete(void * _memory, size_t) noexcept { operator delete(_memory); }
+
+
+/**
+ * @brief stream buffer that throws away everything written to it, so draw()
+ *        can be timed without a terminal
+ */
+class null_buffer : public streambuf
+{
+    protected:
+        int overflow(int _c) override { return traits_type::not_eof(_c); }
+        streamsize xsputn(const char *, streamsize _n) override { return _n; }
+};
+
+
+/**
+ * @brief the timing of one case at one bracket size
+ */
+struct bench_result
+{
+    string    name;         // Case that was timed
+    int       teams;        // Teams in the bracket
+    long long ops;          // Operations timed
+    double    ns;           // Nanoseconds spent in all of them
+    long long allocs;       // Heap allocations made by all of them
+    long long bytes;        // Bytes those allocations asked for
+    string    skipped;      // Why the case didn't run, empty if it did
+};
+
+
+/**
+ * @brief the heap use of rebuilding a bracket at one bracket size
+ */
+struct rebuild_result
+{
+    string    name;         // How the bracket was rebuilt
+    int       teams;        // Teams in the bracket
+    long long allocs;       // Most heap allocations made by one rebuild
+    long long leaked;       // Allocations not freed once the bracket was gone
+    string    skipped;      // Why the check didn't run, empty if it did
+};
+
+// Rebuilds checked at each size, and the most allocations any one may make
+static const int       REBUILD_REPS       = 4;
+static const long long MAX_REBUILD_ALLOCS = 16;
+
+
+/**
+ * @brief the heap use of building a bracket and of forking it at one size
+ */
+struct sharing_result
+{
+    int       teams;        // Teams in the bracket
+    long long build_allocs; // Heap allocations made building it from its file
+    long long fork_bytes;   // Bytes allocated copying it and advancing once
+    string    skipped;      // Why the check didn't run, empty if it did
+};
+
+// Most allocations a build may make, and most bytes a fork may allocate for
+// each square root of the teams on top of FORK_BASE_BYTES
+static const long long MAX_BUILD_ALLOCS    = 16;
+static const double    FORK_BYTES_PER_ROOT = 64;
+static const long long FORK_BASE_BYTES     = 256;
+
+
+/**
+ * @brief the result of checking the seeded matchup order at one bracket size
+ */
+struct seed_order_result
+{
+    int    teams;           // Teams in the bracket
+    string failed;          // What didn't match, empty if everything did
+};
+
+
+/**
+ * @brief runs a case until it has been timed for at least _min_time. Only
+ *        _body is timed and counted; _setup runs before every repetition to
+ *        put the bracket back how _body expects it.
+ *
+ * @param _name is the name of the case
+ * @param _teams is the number of teams in the bracket
+ * @param _min_time is the least time to spend in _body
+ * @param _setup is called before each repetition
+ * @param _body is timed, and returns how many operations it did
+ * @return bench_result: the totals, or why the case was skipped
+ */
+template <class Setup, class Body>
+bench_result measure(const string & _name, int _teams,
+    chrono::nanoseconds _min_time, Setup _setup, Body _body)
+{
+    bench_result        result = {_name, _teams, 0, 0.0, 0, 0, ""};
+    chrono::nanoseconds elapsed(0);
+    const int           MAX_REPS = 1000000;
+
+    try
+    {
+        for (int reps = 0; reps < MAX_REPS && (reps == 0 || elapsed < _min_time); ++reps)
+        {
+            _setup();
+            long long allocs = alloc_count.load(memory_order_relaxed);
+            long long bytes  = alloc_bytes.load(memory_order_relaxed);
+            auto      start  = chrono::steady_clock::now();
+
+            result.ops += _body();
+
+            elapsed += chrono::steady_clock::now() - start;
+            result.allocs += alloc_count.load(memory_order_relaxed) - allocs;
+            result.bytes  += alloc_bytes.load(memory_order_relaxed) - bytes;
+        }
+    }
+    catch (const exception & err)
+    {
+        result.skipped = err.what();
+    }
+    result.ns = elapsed.count();
+    return result;
+}
+
+
+/**
+ * @brief checks that rebuilding a bracket reuses its memory. A bracket is
+ *        built once and then rebuilt REBUILD_REPS times the same way. Each
+ *        rebuild may make at most MAX_REBUILD_ALLOCS heap allocations however
+ *        many teams there are, and once the bracket is destroyed every
+ *        allocation made since before it was built must have been freed. It
+ *        is run with short names and with names too long to fit inside a
+ *        std::string, so names are checked to reuse the last bracket's memory.
+ *
+ * @param _name is the name of the check
+ * @param _teams is the number of teams in the bracket
+ * @param _build builds the bracket it's given
+ * @return rebuild_result: the most allocations of a rebuild and the leaks, or
+ *         why the check was skipped
+ */
+template <class Build>
+rebuild_result check_rebuild(const string & _name, int _teams, Build _build)
+{
+    rebuild_result result = {_name, _teams, 0, 0, ""};
+
+    try
+    {
+        {
+            bracket warm_up(2);     // Makes one-time allocations uncounted
+            _build(warm_up);
+        }
+        long long live = alloc_count.load() - free_count.load();
+        {
+            bracket target(2);
+            _build(target);
+            for (int i = 0; i < REBUILD_REPS; ++i)
+            {
+                long long allocs = alloc_count.load();
+                _build(target);
+                result.allocs = max(result.allocs, alloc_count.load() - allocs);
+            }
+        }
+        result.leaked = alloc_count.load() - free_count.load() - live;
+    }
+    catch (const exception & err)
+    {
+        result.skipped = err.what();
+    }
+    return result;
+}
+
+
+/**
+ * @brief checks that a bracket is built with a few allocations however many
+ *        teams it has, and that a fork of it (a copy advanced once) only
+ *        allocates the pages it writes, about the square root of the teams
+ *
+ * @param _teams is the number of teams in the bracket
+ * @param _teams_file is the division file to build it from
+ * @return sharing_result: the allocations of the build and the bytes of the
+ *         fork, or why the check was skipped
+ */
+sharing_result check_sharing(int _teams, const string & _teams_file)
+{
+    sharing_result result = {_teams, 0, 0, ""};
+
+    try
+    {
+        {
+            bracket warm_up(2);     // Makes one-time allocations uncounted
+            warm_up.init_bracket(_teams_file);
+        }
+        bracket   built(2);
+        long long allocs = alloc_count.load();
+
+        built.init_bracket(_teams_file);
+        result.build_allocs = alloc_count.load() - allocs;
+
+        long long bytes = alloc_bytes.load();
+        bracket   fork(built);
+
+        fork.advance_team(1);
+        result.fork_bytes = alloc_bytes.load() - bytes;
+    }
+    catch (const exception & err)
+    {
+        result.skipped = err.what();
+    }
+    return result;
+}
+
+
+/**
+ * @brief lays out the seeded matchup order the way bracket::order_comp_bracket()
+ *        did before seed_order replaced it: seeds 1 to n are spread into an
+ *        array twice the size and folded back together a doubling group at a
+ *        time. Kept only to check seed_order against.
+ *
+ * @param _teams is the number of teams (2^x)
+ * @param _seeds is filled with the seed at each first round position
+ */
+void reference_seed_order(int _teams, vector<int> & _seeds)
+{
+    vector<int> order(2 * _teams, 0);   // Seeds, 0 for an empty place
+    int group_size = 1;                 // How many seeds are shifting
+    int i, target_index;                // Iterators
+
+    for (int seed = 1; seed <= _teams; ++seed)
+        order[seed - 1] = seed;
+    while (group_size < _teams / 2)
+    {
+        // Space groups apart
+        target_index = _teams*2 - 1 - group_size;
+        i = _teams - 1;
+        while (i > group_size - 1)
+        {
+            for (int j = 0; j < group_size; ++j)
+            {
+                order[target_index] = order[i];
+                order[i] = 0;
+                --target_index;
+                --i;
+            }
+            target_index -= group_size;
+        }
+
+        // Recombine groups
+        target_index = _teams*2 - 1 - group_size;
+        i = group_size;
+        while (i < _teams)
+        {
+            for (int j = 0; j < group_size; ++j)
+            {
+                order[i] = order[target_index];
+                order[target_index] = 0;
+                --target_index;
+                ++i;
+            }
+            target_index -= group_size;
+            i += group_size;
+        }
+        group_size *= 2;
+    }
+    _seeds.assign(order.begin(), order.begin() + _teams);
+}
+
+
+/**
+ * @brief checks seed_order against the order the bracket has always used (see
+ *        reference_seed_order()): fill(), seed_at() and position_of() must all
+ *        agree with it, and the two seeds of every first round game must add
+ *        up to teams + 1
+ *
+ * @param _teams is the number of teams (2^x)
+ * @return seed_order_result: what didn't match, if anything
+ */
+seed_order_result check_seed_order(int _teams)
+{
+    seed_order_result result = {_teams, ""};
+    seed_order        order(_teams);
+    vector<int>       expected, seeds;
+
+    reference_seed_order(_teams, expected);
+    order.fill(seeds);
+    if (seeds != expected)
+        result.failed = "fill()";
+    for (int position = 0; position < _teams && result.failed.empty(); ++position)
+    {
+        if (order.seed_at(position) != expected[position])
+            result.failed = "seed_at(" + to_string(position) + ")";
+        else if (order.position_of(expected[position]) != position)
+            result.failed = "position_of(" + to_string(expected[position]) + ")";
+        else if (position % 2 && expected[position - 1] + expected[position] != _teams + 1)
+            result.failed = "game at " + to_string(position - 1) + " doesn't add up";
+    }
+    return result;
+}
+
+
+/**
+ * @brief decides every game of a bracket, the better seed winning each one
+ *
+ * @param _bracket is a bracket in standard seeding with no games decided
+ * @return long long: the number of games decided
+ */
+long long advance_all(bracket & _bracket)
+{
+    long long games = 0;
+
+    for (int winners = _bracket.num_teams() / 2; winners >= 1; winners /= 2)
+        for (int seed = 1; seed <= winners; ++seed)
+            games += _bracket.advance_team(seed);
+    return games;
+}
+
+
+/**
+ * @brief checks that a bracket loaded from a store is the one saved to it
+ *
+ * @param _saved is the bracket saved
+ * @param _loaded is the bracket loaded back
+ * @throws invalid_argument if they differ
+ */
+void check_round_trip(const bracket & _saved, const bracket & _loaded)
+{
+    string saved, loaded;   // Binary saves of each
+
+    _saved.write_binary(saved);
+    _loaded.write_binary(loaded);
+    if (saved != loaded)
+        throw invalid_argument("Store round trip changed the bracket.");
+}
+
+
+/**
+ * @brief times every case at one bracket size
+ *
+ * @param _teams is the number of teams
+ * @param _dir is a directory for the team and save files
+ * @param _min_time is the least time to spend in each case
+ * @param _filter is a substring a case's name must hold to be timed
+ * @param _results has the results added to it
+ * @param _checks has the rebuild checks added to it
+ * @param _seed_checks has the seed order check added to it
+ * @param _sharing_checks has the build and fork check added to it
+ */
+void run_size(int _teams, const filesystem::path & _dir,
+    chrono::nanoseconds _min_time, const string & _filter,
+    vector<bench_result> & _results, vector<rebuild_result> & _checks,
+    vector<seed_order_result> & _seed_checks, vector<sharing_result> & _sharing_checks)
+{
+    string  teams_file = (_dir / ("teams_" + to_string(_teams) + ".txt")).string();
+    string  saved_file = (_dir / ("saved_" + to_string(_teams) + ".bin")).string();
+    string  long_file  = (_dir / ("long_" + to_string(_teams) + ".txt")).string();
+    string  long_saved = (_dir / ("long_saved_" + to_string(_teams) + ".bin")).string();
+    ostream null_out(new null_buffer);
+    bracket loaded(2);      // Bracket with the file's teams, none advanced
+    bracket decided(2);     // Bracket with every game decided
+
+    auto run = [&](const string & _name, auto _setup, auto _body) {
+        if (_name.find(_filter) == string::npos)
+            return;
+        cerr << _name << " " << _teams << endl;
+        _results.push_back(measure(_name, _teams, _min_time, _setup, _body));
+    };
+    auto none = [] {};
+
+    workload(_teams).write_division(teams_file, _teams);
+    try
+    {
+        loaded.init_bracket(teams_file);
+        decided = loaded;
+        advance_all(decided);
+        decided.save_bracket(saved_file);
+    }
+    catch (const exception &)
+    {}      // Each bracket case below throws again and is skipped
+
+    {
+        bracket target(2);
+        run("init_bracket", none, [&] {
+            target.init_bracket(teams_file);
+            return 1;
+        });
+        run("fill_bracket", none, [&] {
+            target.fill_bracket(saved_file);
+            return 1;
+        });
+    }
+    {
+        vector<int> slots;
+        run("read_final_four", none, [&] {
+            saved_reader reader(saved_file);
+            int          read = 0;
+
+            reader.top_slots(min(2, reader.num_rounds()), slots);
+            for (int slot : slots)
+            {
+                pair<team_id, team_id> spot = reader.get_slot(slot);
+                read += reader.get_team(spot.first).get_seed() > 0;
+                read += reader.get_team(spot.second).get_seed() > 0;
+            }
+            return read;
+        });
+    }
+
+    // A save and a load through each store, the bracket checked between
+    // repetitions (the archive also commits there, untimed)
+    {
+        bracket       source(decided);
+        bracket       target(2);
+        memory_store  memory;
+        archive_store archive((_dir / "brackets.pba").string());
+        bool          loaded = false;
+
+        auto check = [&](bracket_store & _store) {
+            if (decided.num_teams() != _teams)
+                throw invalid_argument("Bracket failed to load.");
+            if (loaded)
+                check_round_trip(source, target);
+            _store.commit();
+            loaded = true;
+        };
+        run("store_memory", [&] { check(memory); }, [&] {
+            memory.save("bracket", source);
+            memory.load("bracket", target);
+            return 1;
+        });
+        loaded = false;
+        run("store_archive", [&] { check(archive); }, [&] {
+            archive.save("bracket", source);
+            archive.load("bracket", target);
+            return 1;
+        });
+        if (loaded)
+            check_round_trip(source, target);
+    }
+    run("save_bracket", [&] {
+        if (decided.num_teams() != _teams)
+            throw invalid_argument("Bracket failed to load.");
+    }, [&] {
+        decided.save_bracket(saved_file);
+        return 1;
+    });
+    run("draw", [&] {
+        if (decided.num_teams() != _teams)
+            throw invalid_argument("Bracket failed to load.");
+    }, [&] {
+        decided.draw(null_out);
+        return 1;
+    });
+
+    {
+        bracket target(2);
+        run("advance_team", [&] {
+            if (loaded.num_teams() != _teams)
+                throw invalid_argument("Bracket failed to load.");
+            target = loaded;
+        }, [&] {
+            return advance_all(target);
+        });
+    }
+
+    {
+        seed_order  order(_teams);
+        vector<int> seeds;
+        int         sum = 0;
+        run("seed_order", none, [&] {
+            order.fill(seeds);
+            return 1;
+        });
+        run("seed_at", none, [&] {
+            for (int i = 0; i < _teams; ++i)
+                sum += order.seed_at(i);
+            return _teams;
+        });
+        if (sum == 1)   // Keeps the lookups from being optimized out
+            cerr << sum;
+        if (string("seed_order").find(_filter) != string::npos)
+            _seed_checks.push_back(check_seed_order(_teams));
+    }
+
+    {
+        optional<bracket> copy;
+        run("copy", [&] {
+            if (decided.num_teams() != _teams)
+                throw invalid_argument("Bracket failed to load.");
+            copy.reset();
+        }, [&] {
+            copy.emplace(decided);
+            return 1;
+        });
+    }
+
+    {
+        optional<bracket> fork;
+        run("fork_advance", [&] {
+            if (loaded.num_teams() != _teams)
+                throw invalid_argument("Bracket failed to load.");
+            fork.reset();
+        }, [&] {
+            fork.emplace(loaded);
+            fork->advance_team(1);
+            return 1;
+        });
+    }
+
+    {
+        bracket_creator creator;
+        for (int i = 0; i < _teams; ++i)
+            creator.add_team(team("SCHOOL " + to_string(i + 1), 0, 0, 0, i + 1));
+        run("is_valid", none, [&] {
+            return creator.is_valid() ? 1 : 0;
+        });
+    }
+
+    if (string("sharing").find(_filter) != string::npos)
+    {
+        cerr << "sharing " << _teams << endl;
+        _sharing_checks.push_back(check_sharing(_teams, teams_file));
+    }
+    if (string("rebuild").find(_filter) != string::npos)
+    {
+        cerr << "rebuild " << _teams << endl;
+        _checks.push_back(check_rebuild("rebuild_init", _teams, [&](bracket & _target) {
+            _target.init_bracket(teams_file);
+        }));
+        _checks.push_back(check_rebuild("rebuild_fill", _teams, [&](bracket & _target) {
+            _target.fill_bracket(saved_file);
+        }));
+
+        workload(_teams).write_division(long_file, _teams, true);
+        try
+        {
+            bracket long_names(2);
+            long_names.init_bracket(long_file);
+            long_names.save_bracket(long_saved);
+        }
+        catch (const exception &)
+        {}      // Each check below throws again and is skipped
+        _checks.push_back(check_rebuild("rebuild_init_long", _teams, [&](bracket & _target) {
+            _target.init_bracket(long_file);
+        }));
+        _checks.push_back(check_rebuild("rebuild_fill_long", _teams, [&](bracket & _target) {
+            _target.fill_bracket(long_saved);
+        }));
+        filesystem::remove(long_file);
+        filesystem::remove(long_saved);
+    }
+
+    delete null_out.rdbuf();
+    filesystem::remove(teams_file);
+    filesystem::remove(saved_file);
+    filesystem::remove(_dir / "brackets.pba");
+}
+
+
+/**
+ * @brief writes the results as JSON
+ *
+ * @param _out is the stream to write to
+ * @param _min_time_ms is the least time spent in each case
+ * @param _results is the results to write
+ * @param _checks is the rebuild checks to write
+ * @param _seed_checks is the seed order checks to write
+ * @param _sharing_checks is the build and fork checks to write
+ * @return true if every check that ran passed
+ */
+bool write_json(ostream & _out, long long _min_time_ms,
+    const vector<bench_result> & _results, const vector<rebuild_result> & _checks,
+    const vector<seed_order_result> & _seed_checks,
+    const vector<sharing_result> & _sharing_checks)
+{
+    bool passed = true;     // If every check passed
+
+    _out << "{\n  \"benchmark\": \"bracket_bench\",\n"
+         << "  \"min_time_ms\": " << _min_time_ms << ",\n"
+         << "  \"max_bracket_teams\": " << MAX_TEAMS << ",\n"
+         << "  \"results\": [";
+    for (size_t i = 0; i < _results.size(); ++i)
+    {
+        const bench_result & r = _results[i];
+        _out << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name
+             << "\", \"teams\": " << r.teams;
+        if (!r.skipped.empty() || r.ops == 0)
+            _out << ", \"skipped\": \""
+                 << (r.skipped.empty() ? "No operations done." : r.skipped) << "\"}";
+        else
+            _out << ", \"ops\": " << r.ops << fixed << setprecision(1)
+                 << ", \"ns_per_op\": " << r.ns / r.ops
+                 << ", \"allocs_per_op\": " << (double)r.allocs / r.ops
+                 << ", \"bytes_per_op\": " << (double)r.bytes / r.ops << "}";
+    }
+    _out << "\n  ],\n  \"rebuild_checks\": [";
+    for (size_t i = 0; i < _checks.size(); ++i)
+    {
+        const rebuild_result & r = _checks[i];
+        bool ok = r.allocs <= MAX_REBUILD_ALLOCS && r.leaked == 0;
+        _out << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name
+             << "\", \"teams\": " << r.teams;
+        if (!r.skipped.empty())
+            _out << ", \"skipped\": \"" << r.skipped << "\"}";
+        else
+        {
+            _out << ", \"allocs_per_rebuild\": " << r.allocs
+                 << ", \"leaked_allocs\": " << r.leaked
+                 << ", \"passed\": " << (ok ? "true" : "false") << "}";
+            passed = passed && ok;
+        }
+    }
+    _out << "\n  ],\n  \"seed_order_checks\": [";
+    for (size_t i = 0; i < _seed_checks.size(); ++i)
+    {
+        const seed_order_result & r = _seed_checks[i];
+        _out << (i ? ",\n" : "\n") << "    {\"teams\": " << r.teams
+             << ", \"passed\": " << (r.failed.empty() ? "true" : "false");
+        if (!r.failed.empty())
+            _out << ", \"failed\": \"" << r.failed << "\"";
+        _out << "}";
+        passed = passed && r.failed.empty();
+    }
+    _out << "\n  ],\n  \"sharing_checks\": [";
+    for (size_t i = 0; i < _sharing_checks.size(); ++i)
+    {
+        const sharing_result & r = _sharing_checks[i];
+        long long max_fork = FORK_BASE_BYTES + (long long)(FORK_BYTES_PER_ROOT * sqrt(r.teams));
+        bool      ok       = r.build_allocs <= MAX_BUILD_ALLOCS && r.fork_bytes <= max_fork;
+        _out << (i ? ",\n" : "\n") << "    {\"teams\": " << r.teams;
+        if (!r.skipped.empty())
+            _out << ", \"skipped\": \"" << r.skipped << "\"}";
+        else
+        {
+            _out << ", \"build_allocs\": " << r.build_allocs
+                 << ", \"fork_advance_bytes\": " << r.fork_bytes
+                 << ", \"max_fork_advance_bytes\": " << max_fork
+                 << ", \"passed\": " << (ok ? "true" : "false") << "}";
+            passed = passed && ok;
+        }
+    }
+    _out << "\n  ]\n}\n";
+    return passed;
+}
+
+
+int main(int argc, char ** argv)
+{
+    long long            min_time_ms = 200;
+    long long            max_teams   = 1 << 20;
+    string               filter;
+    string               out_file;
+    vector<bench_result> results;
+    vector<rebuild_result> checks;
+    vector<seed_order_result> seed_checks;
+    vector<sharing_result> sharing_checks;
+    bool                 passed;
+    filesystem::path     dir = filesystem::temp_directory_path() / "bracket_bench";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (i + 1 < argc && arg == "--min-time")
+            min_time_ms = atoll(argv[++i]);
+        else if (i + 1 < argc && arg == "--max-teams")
+            max_teams = atoll(argv[++i]);
+        else if (i + 1 < argc && arg == "--filter")
+            filter = argv[++i];
+        else if (i + 1 < argc && arg == "--out")
+            out_file = argv[++i];
+        else
+        {
+            cerr << "Usage: " << argv[0] << " [--min-time MS] [--max-teams N]"
+                 << " [--filter NAME] [--out FILE]" << endl;
+            return 1;
+        }
+    }
+
+    filesystem::create_directories(dir);
+    for (long long teams = 2; teams <= max_teams && teams <= (1 << 20); teams *= 2)
+        run_size(teams, dir, chrono::milliseconds(min_time_ms), filter, results, checks,
+            seed_checks, sharing_checks);
+    filesystem::remove_all(dir);
+
+    if (out_file.empty())
+        passed = write_json(cout, min_time_ms, results, checks, seed_checks, sharing_checks);
+    else
+    {
+        ofstream out(out_file, ofstream::out | ofstream::trunc);
+        passed = write_json(out, min_time_ms, results, checks, seed_checks, sharing_checks);
+    }
+    return passed ? 0 : 2;
+}
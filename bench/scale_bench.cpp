@@ -0,0 +1,248 @@
+/**
+ * @file scale_bench.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Scaling suite for brackets of 2^1 up to MAX_TEAMS (2^24) teams. At
+ *        each size it builds a bracket from a division file, decides every
+ *        game, saves it, reloads the save and checks the reload matches, and
+ *        scores a pool with the default points against it, checking that a
+ *        perfect entry and an empty one get the right scores and ranks. It
+ *        reports the time of each step and the peak resident memory as JSON,
+ *        and exits with 2 if a size that ran didn't match or score right.
+ *
+ *        Build from the repository root with every source but main.cpp:
+ *        g++ -std=c++17 -O2 -pthread -I. bench/scale_bench.cpp
+ *            bench/workload.cpp <sources>
+ *
+ *        Options:
+ *        --min-teams N   smallest bracket, a power of two (default 2)
+ *        --max-teams N   largest bracket, a power of two (default MAX_TEAMS)
+ *        --out FILE      write the report to FILE instead of stdout
+ *
+ *        Peak memory is the high water mark of the whole process. Sizes run
+ *        from smallest to largest and each doubles the last, so the peak after
+ *        a size is that size's own peak.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+#include "bracket.h"
+#include "pool.h"
+#include "workload.h"
+#include "saved_format.h"
+using namespace std;
+
+
+/**
+ * @brief the timings of one bracket size
+ */
+struct scale_result
+{
+    int       teams;        // Teams in the bracket
+    double    build_ms;     // init_bracket() from the division file
+    double    advance_ms;   // Deciding every game
+    double    save_ms;      // save_bracket()
+    double    reload_ms;    // fill_bracket() from the save
+    double    score_ms;     // Scoring a pool of two entries against it
+    long long file_bytes;   // Size of the save
+    long long peak_rss;     // Peak resident bytes of the process so far
+    bool      matches;      // If the reload matched the saved bracket
+    bool      scored;       // If the pool's scores and ranks were right
+    string    error;        // Why the size stopped early, if it did
+};
+
+
+/**
+ * @brief finds the most memory the process has held at once
+ *
+ * @return long long: the peak resident set size in bytes
+ */
+long long peak_rss()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    #ifdef __APPLE__
+        return usage.ru_maxrss;         // Bytes on macOS
+    #else
+        return usage.ru_maxrss * 1024LL; // Kilobytes elsewhere
+    #endif
+#endif
+}
+
+
+/**
+ * @brief times a step
+ *
+ * @param _step is the step to run
+ * @return double: the milliseconds it took
+ */
+template <class Step>
+double time_ms(Step _step)
+{
+    auto start = chrono::steady_clock::now();
+    _step();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+
+/**
+ * @brief builds, advances, saves and reloads a bracket of one size
+ *
+ * @param _teams is the number of teams
+ * @param _dir is a directory for the division and save files
+ * @return scale_result: the timing of each step
+ */
+scale_result run_size(int _teams, const filesystem::path & _dir)
+{
+    scale_result result   = {_teams, 0, 0, 0, 0, 0, 0, 0, false, false, ""};
+    string       division = (_dir / "division.txt").string();
+    string       saved    = (_dir / ("saved" + string(SAVED_EXTENSION))).string();
+
+    try {
+        workload(_teams).write_division(division, _teams);
+        {
+            bracket built;
+            bracket reloaded;
+            bracket seeded;     // Built bracket with no games decided
+
+            result.build_ms   = time_ms([&] { built.init_bracket(division); });
+            seeded = built;
+            result.advance_ms = time_ms([&] {
+                for (int winners = _teams / 2; winners >= 1; winners /= 2)
+                    for (int seed = 1; seed <= winners; ++seed)
+                        built.advance_team(seed);
+            });
+            result.save_ms    = time_ms([&] { built.save_bracket(saved); });
+            result.file_bytes = filesystem::file_size(saved);
+            result.reload_ms  = time_ms([&] { reloaded.fill_bracket(saved); });
+
+            result.matches = reloaded.num_teams() == _teams &&
+                reloaded.get_champion() == 0 &&
+                reloaded.get_picks() == built.get_picks() &&
+                reloaded.get_team(_teams - 1).get_name() == built.get_team(_teams - 1).get_name();
+
+            result.score_ms = time_ms([&] {
+                pool scores(built);
+
+                scores.add_entry("perfect", built);
+                scores.add_entry("seeded", seeded);
+                scores.score();
+                result.scored = scores.get_score(0) == scores.max_score() &&
+                    scores.get_rank(0) == 1 && scores.get_score(1) == 0 &&
+                    scores.get_rank(1) == 2;
+            });
+        }
+    }
+    catch (const exception & err) {
+        result.error = err.what();
+    }
+    result.peak_rss = peak_rss();
+
+    filesystem::remove(division);
+    filesystem::remove(saved);
+    return result;
+}
+
+
+/**
+ * @brief writes the results as JSON
+ *
+ * @param _out is the stream to write to
+ * @param _results is the results to write
+ */
+void write_json(ostream & _out, const vector<scale_result> & _results)
+{
+    _out << "{\n  \"benchmark\": \"scale_bench\",\n"
+         << "  \"max_bracket_teams\": " << MAX_TEAMS << ",\n"
+         << "  \"results\": [";
+    for (size_t i = 0; i < _results.size(); ++i)
+    {
+        const scale_result & r = _results[i];
+        _out << (i ? ",\n" : "\n") << "    {\"teams\": " << r.teams << fixed
+             << setprecision(3)
+             << ", \"build_ms\": " << r.build_ms
+             << ", \"advance_ms\": " << r.advance_ms
+             << ", \"save_ms\": " << r.save_ms
+             << ", \"reload_ms\": " << r.reload_ms
+             << ", \"score_ms\": " << r.score_ms
+             << ", \"file_bytes\": " << r.file_bytes
+             << ", \"peak_rss_bytes\": " << r.peak_rss
+             << ", \"matches\": " << (r.matches ? "true" : "false")
+             << ", \"scored\": " << (r.scored ? "true" : "false");
+        if (!r.error.empty())
+            _out << ", \"error\": \"" << r.error << "\"";
+        _out << "}";
+    }
+    _out << "\n  ]\n}\n";
+}
+
+
+int main(int argc, char ** argv)
+{
+    long long            min_teams = 2;
+    long long            max_teams = MAX_TEAMS;
+    bool                 usage     = false;
+    bool                 passed    = true;
+    string               out_file;
+    vector<scale_result> results;
+    filesystem::path     dir = filesystem::temp_directory_path() / "scale_bench";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (i + 1 < argc && arg == "--min-teams")
+            min_teams = atoll(argv[++i]);
+        else if (i + 1 < argc && arg == "--max-teams")
+            max_teams = atoll(argv[++i]);
+        else if (i + 1 < argc && arg == "--out")
+            out_file = argv[++i];
+        else
+            usage = true;
+    }
+    if (usage || min_teams < 2)
+    {
+        cerr << "Usage: " << argv[0] << " [--min-teams N] [--max-teams N]"
+             << " [--out FILE]" << endl;
+        return 1;
+    }
+
+    filesystem::create_directories(dir);
+    for (long long teams = min_teams; teams <= max_teams && teams <= MAX_TEAMS; teams *= 2)
+    {
+        cerr << teams << endl;
+        results.push_back(run_size(teams, dir));
+
+        // A size that stopped early (such as out of memory) is only reported,
+        // but one that reloaded right has to have scored right too
+        const scale_result & r = results.back();
+        if ((r.error.empty() && !r.matches) || (r.matches && !r.scored))
+            passed = false;
+    }
+    filesystem::remove_all(dir);
+
+    if (out_file.empty())
+        write_json(cout, results);
+    else
+    {
+        ofstream out(out_file, ofstream::out | ofstream::trunc);
+        write_json(out, results);
+    }
+    return passed ? 0 : 2;
+}
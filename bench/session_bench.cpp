@@ -0,0 +1,373 @@
+/**
+ * @file session_bench.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Times whole sessions of the program end to end. Each session is a
+ *        canned stream of menu choices fed to bracket_driver::start() through
+ *        cin, with its output going to a counting stream instead of cout, so
+ *        menus, input checking, loads, edits, views and saves are all timed
+ *        together. Every run starts from a fresh synthetic resources tree (see
+ *        workload.h), and the report is JSON.
+ *
+ *        Build from the repository root with every source but main.cpp:
+ *        g++ -std=c++17 -O2 -pthread -I. bench/session_bench.cpp
+ *            bench/workload.cpp <sources>
+ *
+ *        Options:
+ *        --teams N       teams in the division, a power of two (default 64)
+ *        --entries N     entries in the pool that is scored (default 1000)
+ *        --fill F        share of games decided in the saved bracket (0.5)
+ *        --trials N      tournaments simulated, 0 for exact odds (1000)
+ *        --reps N        runs of each session (default 5)
+ *        --filter NAME   only run sessions whose name holds NAME
+ *        --transcript F  write what the sessions printed to F
+ *        --out FILE      write the report to FILE instead of stdout
+ *
+ *        Brackets of MAX_DRAWN_TEAMS teams or less are drawn whole, and are
+ *        repainted in place if stdout is a terminal, so send the report to a
+ *        file or pipe when comparing runs.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include "bracket_driver.h"
+#include "workload.h"
+#include "saved_format.h"
+using namespace std;
+namespace fs = std::filesystem;
+
+
+/**
+ * @brief stream buffer that counts the bytes written to it and passes them on
+ *        to another buffer, or drops them if there is none
+ */
+class counting_buffer : public streambuf
+{
+    public:
+        counting_buffer(streambuf * _next) : next(_next), count(0) {}
+        long long bytes() const { return count; }
+
+    protected:
+        int overflow(int _c) override
+        {
+            if (_c != traits_type::eof())
+            {
+                ++count;
+                if (next)
+                    next->sputc(_c);
+            }
+            return traits_type::not_eof(_c);
+        }
+        streamsize xsputn(const char * _s, streamsize _n) override
+        {
+            count += _n;
+            if (next)
+                next->sputn(_s, _n);
+            return _n;
+        }
+
+    private:
+        streambuf * next;   // Buffer the output goes on to, if any
+        long long   count;  // Bytes written so far
+};
+
+
+/**
+ * @brief settings shared by every session
+ */
+struct session_config
+{
+    int      teams;         // Teams in the division
+    int      entries;       // Entries in the pool
+    double   fill;          // Share of games decided in the saved bracket
+    int      trials;        // Tournaments simulated
+    uint32_t seed;          // Seed of the workload
+};
+
+
+/**
+ * @brief one scripted session: how to set up the resources tree, and the input
+ *        to feed the program once it is set up
+ */
+struct session
+{
+    string name;
+    function<void(workload &, const fs::path &)> setup;
+    function<string(const fs::path &)>           script;
+};
+
+
+/**
+ * @brief the timing of every run of one session
+ */
+struct session_result
+{
+    string         name;
+    vector<double> ms;              // Time of each run
+    long long      input_bytes;     // Size of the script
+    long long      output_bytes;    // Bytes the last run printed
+    string         error;           // Why a run stopped early, if one did
+};
+
+
+/**
+ * @brief finds where a file is listed in a directory, counting from 1, the
+ *        same way the program numbers the files it lists (sorted by name)
+ *
+ * @param _dir is the directory
+ * @param _file_name is the file to look for
+ * @return int: the number the file is listed as, 0 if it isn't there
+ */
+int menu_number(const fs::path & _dir, const string & _file_name)
+{
+    vector<string> names;   // Files in the directory
+
+    for (const auto & entry : fs::directory_iterator(_dir))
+        if (entry.path().extension() != ".log" && entry.path().extension() != ".tmp")
+            names.push_back(entry.path().filename().string());
+    sort(names.begin(), names.end());
+
+    auto found = find(names.begin(), names.end(), _file_name);
+    return found == names.end() ? 0 : found - names.begin() + 1;
+}
+
+
+/**
+ * @brief makes the sessions to time
+ *
+ * @param _config is the settings shared by every session
+ * @return vector<session>: the sessions, in the order to run them
+ */
+vector<session> make_sessions(const session_config & _config)
+{
+    const int    teams    = _config.teams;
+    const int    rounds   = log2(teams);
+    const string division = "division.txt";
+    const string saved    = string("division_saved") + SAVED_EXTENSION;
+    vector<session> sessions;
+
+    auto write_division = [=](workload & _work, const fs::path & _root) {
+        _work.write_division((_root / "resources" / "new" / division).string(), teams);
+    };
+    auto write_saved = [=](workload & _work, const fs::path & _root) {
+        write_division(_work, _root);
+        _work.write_saved((_root / "resources" / "new" / division).string(),
+            (_root / "resources" / "saved" / saved).string(), _config.fill);
+    };
+    // Looks at the top region and the first seed's path
+    string views = "3\n" + to_string(rounds) + "\n1\n" + to_string(min(rounds, 3))
+        + "\n4\n1\n";
+
+    // Start a bracket, pick every first round game and save it under a name
+    sessions.push_back({"new_advance_save", write_division, [=](const fs::path &) {
+        string script = "1\n1\n";
+        for (int seed = 1; seed <= teams / 2; ++seed)
+            script += "1\n" + to_string(seed) + "\n";
+        return script + views + "0\nY\nsession\n0\n";
+    }});
+
+    // Open a saved bracket, advance random teams and save it over itself
+    sessions.push_back({"open_advance_save", write_saved, [=](const fs::path & _root) {
+        mt19937 random(_config.seed);
+        string  script = "2\n" + to_string(menu_number(_root / "resources" / "saved", saved)) + "\n";
+        for (int i = 0; i < teams / 2; ++i)
+            script += "1\n" + to_string(random() % teams + 1) + "\n";
+        return script + views + "0\nY\n0\n";
+    }});
+
+    // Simulate the saved bracket's odds
+    sessions.push_back({"simulate", write_saved, [=](const fs::path & _root) {
+        return "5\n" + to_string(menu_number(_root / "resources" / "saved", saved))
+            + "\n" + to_string(_config.trials) + "\n0\n";
+    }});
+
+    // Score a pool of entries against a bracket of results
+    sessions.push_back({"score_pool", [=](workload & _work, const fs::path & _root) {
+        string new_file = (_root / "resources" / "new" / division).string();
+        write_division(_work, _root);
+        _work.write_saved(new_file,
+            (_root / "resources" / "saved" / ("results" + string(SAVED_EXTENSION))).string(), 1.0);
+        _work.write_pool(new_file, (_root / "resources" / "saved").string(), _config.entries);
+    }, [=](const fs::path & _root) {
+        return "6\n" + to_string(menu_number(_root / "resources" / "saved",
+            "results" + string(SAVED_EXTENSION)))
+            + "\n0\n";
+    }});
+
+    // Delete the saved bracket
+    sessions.push_back({"delete", write_saved, [=](const fs::path & _root) {
+        return "3\n" + to_string(menu_number(_root / "resources" / "saved", saved))
+            + "\nY\n0\n";
+    }});
+
+    return sessions;
+}
+
+
+/**
+ * @brief runs a session _reps times, each from a fresh resources tree
+ *
+ * @param _session is the session to run
+ * @param _config is the settings shared by every session
+ * @param _root is the directory the program runs in
+ * @param _reps is the number of runs
+ * @param _transcript gets what the program printed, if not null
+ * @return session_result: the time of each run
+ */
+session_result run_session(const session & _session, const session_config & _config,
+    const fs::path & _root, int _reps, streambuf * _transcript)
+{
+    session_result result = {_session.name, {}, 0, 0, ""};
+    fs::path       home   = fs::current_path();
+
+    for (int rep = 0; rep < _reps && result.error.empty(); ++rep)
+    {
+        workload work(_config.seed + rep);
+
+        fs::remove_all(_root);
+        fs::create_directories(_root / "resources" / "new");
+        fs::create_directories(_root / "resources" / "saved");
+        _session.setup(work, _root);
+
+        istringstream   input(_session.script(_root));
+        counting_buffer output(_transcript);
+        streambuf *     old_in  = cin.rdbuf(input.rdbuf());
+        streambuf *     old_out = cout.rdbuf(&output);
+
+        result.input_bytes = input.str().size();
+        fs::current_path(_root);
+        auto start = chrono::steady_clock::now();
+        try {
+            bracket_driver driver;
+            driver.start();
+        }
+        catch (const exception & err) {
+            result.error = err.what();
+        }
+        auto stop = chrono::steady_clock::now();
+        fs::current_path(home);
+        cout.rdbuf(old_out);
+        cin.rdbuf(old_in);
+        cin.clear();
+
+        result.ms.push_back(chrono::duration<double, milli>(stop - start).count());
+        result.output_bytes = output.bytes();
+    }
+    return result;
+}
+
+
+/**
+ * @brief writes the results as JSON
+ *
+ * @param _out is the stream to write to
+ * @param _config is the settings shared by every session
+ * @param _results is the results to write
+ */
+void write_json(ostream & _out, const session_config & _config,
+    const vector<session_result> & _results)
+{
+    _out << "{\n  \"benchmark\": \"session_bench\",\n"
+         << "  \"teams\": " << _config.teams << ",\n"
+         << "  \"entries\": " << _config.entries << ",\n"
+         << "  \"fill\": " << _config.fill << ",\n"
+         << "  \"trials\": " << _config.trials << ",\n"
+         << "  \"results\": [";
+    for (size_t i = 0; i < _results.size(); ++i)
+    {
+        const session_result & r = _results[i];
+        double total = 0, best = r.ms.empty() ? 0 : r.ms[0];
+        for (double ms : r.ms)
+        {
+            total += ms;
+            best   = min(best, ms);
+        }
+
+        _out << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name << "\""
+             << ", \"reps\": " << r.ms.size() << fixed << setprecision(3)
+             << ", \"ms_min\": " << best
+             << ", \"ms_mean\": " << (r.ms.empty() ? 0 : total / r.ms.size())
+             << ", \"input_bytes\": " << r.input_bytes
+             << ", \"output_bytes\": " << r.output_bytes;
+        if (!r.error.empty())
+            _out << ", \"error\": \"" << r.error << "\"";
+        _out << "}";
+    }
+    _out << "\n  ]\n}\n";
+}
+
+
+int main(int argc, char ** argv)
+{
+    session_config         config  = {64, 1000, 0.5, 1000, 1};
+    int                    reps    = 5;
+    bool                   usage   = false;
+    string                 filter;
+    string                 out_file;
+    string                 transcript_file;
+    ofstream               transcript;
+    vector<session_result> results;
+    fs::path               root = fs::temp_directory_path() / "session_bench";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (i + 1 >= argc)
+            usage = true;
+        else if (arg == "--teams")
+            config.teams = atoi(argv[++i]);
+        else if (arg == "--entries")
+            config.entries = atoi(argv[++i]);
+        else if (arg == "--fill")
+            config.fill = atof(argv[++i]);
+        else if (arg == "--trials")
+            config.trials = atoi(argv[++i]);
+        else if (arg == "--reps")
+            reps = atoi(argv[++i]);
+        else if (arg == "--filter")
+            filter = argv[++i];
+        else if (arg == "--transcript")
+            transcript_file = argv[++i];
+        else if (arg == "--out")
+            out_file = argv[++i];
+        else
+            usage = true;
+    }
+    if (usage || config.teams < 2 || (config.teams & (config.teams - 1)))
+    {
+        cerr << "Usage: " << argv[0] << " [--teams N] [--entries N] [--fill F]"
+             << " [--trials N] [--reps N] [--filter NAME] [--transcript FILE]"
+             << " [--out FILE]" << endl;
+        return 1;
+    }
+    if (!transcript_file.empty())
+        transcript.open(transcript_file, ofstream::out | ofstream::trunc);
+
+    for (const session & s : make_sessions(config))
+    {
+        if (s.name.find(filter) == string::npos)
+            continue;
+        cerr << s.name << endl;
+        results.push_back(run_session(s, config, root, reps,
+            transcript.is_open() ? transcript.rdbuf() : nullptr));
+    }
+    fs::remove_all(root);
+
+    if (out_file.empty())
+        write_json(cout, config, results);
+    else
+    {
+        ofstream out(out_file, ofstream::out | ofstream::trunc);
+        write_json(out, config, results);
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file workload.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the workload class which writes
+ *        synthetic inputs for benchmarks.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "workload.h"
+#include "saved_format.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <filesystem>
+using namespace std;
+
+// Parameterized constructor
+workload::workload(uint32_t _seed) : random(_seed)
+{}
+
+
+/**
+ * @brief writes a division file (resources/new format) with made up schools
+ *        and records, listed in shuffled order
+ *
+ * @param _file_name is the file to write
+ * @param _teams is the number of teams, a power of two of at least 2
+ * @param _long_names is if the schools are named "NORTH VALLEY REGIONAL
+ *        SCHOOL n" instead of "SCHOOL n", which is too long for a std::string
+ *        to hold without allocating
+ * @throws invalid_argument if the number of teams isn't a power of two
+ */
+void workload::write_division(const string & _file_name, int _teams,
+    bool _long_names)
+{
+    vector<int> seeds(_teams > 0 ? _teams : 0);
+    string      buffer;     // Whole file, written at once
+    ofstream    out;
+
+    if (_teams < 2 || (_teams & (_teams - 1)))
+        throw invalid_argument("Number of teams isn't power of two.");
+
+    for (int i = 0; i < _teams; ++i)
+        seeds[i] = i + 1;
+    shuffle(seeds.begin(), seeds.end(), random);
+
+    buffer.reserve(_teams * 56);
+    for (int seed : seeds)
+    {
+        int wins = random() % 13;
+        buffer += (_long_names ? "NORTH VALLEY REGIONAL SCHOOL " : "SCHOOL ") + to_string(seed) + ';' + to_string(wins) + ';'
+            + to_string(12 - wins) + ';' + to_string(random() % 2) + ';'
+            + to_string(seed) + '\n';
+    }
+
+    out.open(_file_name, ofstream::out | ofstream::trunc | ofstream::binary);
+    out.write(buffer.data(), buffer.size());
+    if (!out)
+        throw invalid_argument("Could not write " + _file_name + ".");
+}
+
+
+/**
+ * @brief decides games of a bracket with random winners, every game of a round
+ *        before any game of the next, until _fill of the games are decided.
+ *        The last game decided is the final, which crowns the champion.
+ *
+ * @param _bracket is the bracket to fill, with no games decided
+ * @param _fill is the share of games to decide, from 0 to 1
+ * @return int: the number of games decided
+ */
+int workload::fill(bracket & _bracket, double _fill)
+{
+    int games   = _bracket.num_teams() - 1;     // Games, the final included
+    int to_fill = (int)(min(max(_fill, 0.0), 1.0) * games + 0.5);
+
+    // Heap order from the last slot back is the first round, then the next...
+    for (int i = 0; i < to_fill; ++i)
+    {
+        const pair<team_id, team_id> & spot = _bracket.get_slot(games - 1 - i).get_pair();
+        team_id winner = random() & 1 ? spot.second : spot.first;
+        _bracket.advance_team(winner + 1);
+    }
+    return to_fill;
+}
+
+
+/**
+ * @brief writes a saved bracket (resources/saved format) of a division with
+ *        some of its games decided
+ *
+ * @param _division is the division file to make the bracket from
+ * @param _file_name is the file to save to
+ * @param _fill is the share of games to decide, from 0 to 1
+ * @param _text is if the older text format is written instead of binary
+ */
+void workload::write_saved(const string & _division, const string & _file_name,
+    double _fill, bool _text)
+{
+    bracket saved;
+
+    saved.init_bracket(_division);
+    fill(saved, _fill);
+    if (_text)
+        saved.save_bracket_text(_file_name);
+    else
+        saved.save_bracket(_file_name);
+}
+
+
+/**
+ * @brief writes a pool of saved brackets of one division with every game
+ *        decided, named entry_000001.pbrk, entry_000002.pbrk, ...
+ *
+ * @param _division is the division file to make the brackets from
+ * @param _dir is the directory to write them into
+ * @param _entries is the number of brackets to write
+ */
+void workload::write_pool(const string & _division, const string & _dir,
+    int _entries)
+{
+    bracket seeded;     // Division with no games decided
+    bracket entry;      // Each entry, copied from seeded
+
+    seeded.init_bracket(_division);
+    for (int i = 1; i <= _entries; ++i)
+    {
+        ostringstream name;
+        name << "entry_" << setw(6) << setfill('0') << i << SAVED_EXTENSION;
+
+        entry = seeded;
+        fill(entry, 1.0);
+        entry.save_bracket((filesystem::path(_dir) / name.str()).string());
+    }
+}
@@ -0,0 +1,48 @@
+/**
+ * @file workload.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the workload class which writes synthetic
+ *        division files, saved brackets and pools for benchmarks.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef WORKLOAD
+#define WORKLOAD
+
+#include <string>
+#include <random>
+#include <cstdint>
+#include "bracket.h"
+
+/**
+ * @brief Writes reproducible inputs of any size. Division files are in the
+ *        resources/new format with the teams in shuffled order, and saved
+ *        brackets are in the resources/saved format with a given share of
+ *        their games decided, earliest rounds first and each winner picked at
+ *        random. A pool is many saved brackets of one division with every game
+ *        decided. Everything written comes from one random generator, so the
+ *        same seed always writes the same files.
+ */
+class workload
+{
+    public:
+        workload(std::uint32_t _seed);  // Param. constructor
+
+        // Write a division file of _teams teams (a power of two), with names
+        // too long to fit inside a std::string if _long_names
+        void write_division(const std::string & _file_name, int _teams,
+            bool _long_names = false);
+        // Write a save of a division's bracket with _fill of its games decided
+        void write_saved(const std::string & _division, const std::string & _file_name,
+            double _fill, bool _text = false);
+        // Write _entries saves of a division's bracket into a directory
+        void write_pool(const std::string & _division, const std::string & _dir,
+            int _entries);
+        // Decide the first _fill of a bracket's games, earliest rounds first
+        int  fill(bracket & _bracket, double _fill);
+
+    private:
+        std::mt19937 random;    // Source of every random pick
+};
+
+#endif
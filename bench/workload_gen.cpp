@@ -0,0 +1,90 @@
+/**
+ * @file workload_gen.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Writes a synthetic resources tree: a division file, saved brackets of
+ *        it at chosen fill ratios, and a pool of random entries.
+ *
+ *        Build from the repository root with every source but main.cpp:
+ *        g++ -std=c++17 -O2 -pthread -I. bench/workload_gen.cpp
+ *            bench/workload.cpp <sources>
+ *
+ *        Usage: workload_gen DIR [options]
+ *        --teams N       teams in the division, a power of two (default 64)
+ *        --fill F        write a save with F (0 to 1) of its games decided,
+ *                        can be given more than once
+ *        --entries N     write a pool of N entries (default 0)
+ *        --text          write saves in the older text format
+ *        --seed S        seed of the random generator (default 1)
+ *
+ *        Files go in DIR/resources/new and DIR/resources/saved, so running the
+ *        program from DIR opens them.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <filesystem>
+#include "workload.h"
+#include "saved_format.h"
+using namespace std;
+
+int main(int argc, char ** argv)
+{
+    int              teams   = 64;
+    int              entries = 0;
+    bool             text    = false;
+    bool             usage   = false;   // If the arguments were wrong
+    uint32_t         seed    = 1;
+    vector<double>   fills;
+    filesystem::path root;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (i + 1 < argc && arg == "--teams")
+            teams = atoi(argv[++i]);
+        else if (i + 1 < argc && arg == "--fill")
+            fills.push_back(atof(argv[++i]));
+        else if (i + 1 < argc && arg == "--entries")
+            entries = atoi(argv[++i]);
+        else if (i + 1 < argc && arg == "--seed")
+            seed = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--text")
+            text = true;
+        else if (root.empty() && arg[0] != '-')
+            root = arg;
+        else
+            usage = true;
+    }
+    if (usage || root.empty())
+    {
+        cerr << "Usage: " << argv[0] << " DIR [--teams N] [--fill F]..."
+             << " [--entries N] [--text] [--seed S]" << endl;
+        return 1;
+    }
+
+    try {
+        workload         generator(seed);
+        filesystem::path new_dir   = root / "resources" / "new";
+        filesystem::path saved_dir = root / "resources" / "saved";
+        string           name      = "division_" + to_string(teams);
+        string           division  = (new_dir / (name + ".txt")).string();
+
+        filesystem::create_directories(new_dir);
+        filesystem::create_directories(saved_dir);
+        generator.write_division(division, teams);
+        for (double fill : fills)
+            generator.write_saved(division, (saved_dir / (name + "_" +
+                to_string((int)(fill * 100 + 0.5)) + "_saved" +
+                (text ? ".txt" : SAVED_EXTENSION))).string(),
+                fill, text);
+        generator.write_pool(division, saved_dir.string(), entries);
+    }
+    catch (const exception & err) {
+        cerr << err.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -2,63 +2,72 @@
  * @file bracket.cpp
  * @author Henry Kaus (https://github.com/henrykaus)
  * @brief Holds method definitions for the bracket class which controls a fully
- *        featured BST for a modifiable bracket. 
+ *        featured BST for a modifiable bracket, stored as a heap-ordered array.
  * 
  * @copyright Copyright (c) 2022
  */
 #include "bracket.h"
+#include "bracket_renderer.h"
 using namespace std;
 
+/**
+ * @brief Returns the lock held while a save is replaced or its edit log is read
+ *        or written, so a load never sees a new save with the log of the old one
+ * 
+ * @return mutex &: the lock, one for the whole program
+ */
+mutex & saved_file_lock()
+{
+    static mutex lock;
+    return lock;
+}
+
 // Default constructor
-bracket::bracket() : root(nullptr)
+bracket::bracket() : bracket_spots(0), champion(NO_TEAM), saved_checksum(0),
+    log_edits(0), rewrite(true)
 {
     init(32);
 }
 
 
 // Copy constructor
-bracket::bracket(const bracket & _source) : root(nullptr)
+bracket::bracket(const bracket & _source) : bracket_spots(0), champion(NO_TEAM),
+    saved_checksum(0), log_edits(0), rewrite(true)
 {
     copy_bracket(_source);
 }
 
 
 /**
- * @brief private helper to deep copy from a source bracket to this one
+ * @brief private helper to copy from a source bracket to this one. The team
+ *        table is never written after it is loaded, so both brackets share it,
+ *        and the slots and seed index share their pages until one of the
+ *        brackets writes them (see cow_array.h). A copy costs a pointer per
+ *        page, and each advance on either bracket after it clones a page or two.
+ *        The copy starts its own edit journal, so it can't undo past the copy,
+ *        and is saved whole the first time.
  * 
- * @param _source is a bracket to deep copy from
+ * @param _source is a bracket to copy from
  */
 void bracket::copy_bracket(const bracket & _source)
 {
+    finish_compaction();
     bracket_spots = _source.bracket_spots;
-    bracket_gap   = _source.bracket_gap;
-
-    if (_source.root)
-        copy_bracket(root, _source.root);
-}
-
-
-/**
- * @brief a private helper to recursively deep copy a bracket
- * 
- * @param _dest_root is the destination node for copy
- * @param _source_root is the source node for copying from
- */
-void bracket::copy_bracket(node *& _dest_root, node * _source_root)
-{
-    if (_source_root)
-    {
-        _dest_root = new node(*_source_root);
-        copy_bracket(_dest_root->get_left(), _source_root->get_left());
-        copy_bracket(_dest_root->get_right(), _source_root->get_right());
-    }
-    else
-        _dest_root = nullptr;
+    slots         = _source.slots;
+    teams         = _source.teams;
+    seed_slots    = _source.seed_slots;
+    champion      = _source.champion;
+    journal.clear();
+    saved_file.clear();
+    unsaved.clear();
+    log_edits     = 0;
+    rewrite       = true;
 }
 
 
 // Parameterized constructor
-bracket::bracket(int _bracket_teams) : root(nullptr)
+bracket::bracket(int _bracket_teams) : bracket_spots(0), champion(NO_TEAM),
+    saved_checksum(0), log_edits(0), rewrite(true)
 {
     init(_bracket_teams);
 }
@@ -77,503 +86,835 @@ bracket & bracket::operator = (const bracket & _source)
  * @brief a private helper to initialize the bracket with a number of teams
  * 
  * @param _bracket_teams is the number of teams that the bracket will have
- *        (1) Must be a power of 2
- * @throws invalid_argument if the number of teams is 1 or not a power of 2
+ *        (1) Must be a power of 2 of at least 2
+ *        (2) Must be at most MAX_TEAMS
+ * @throws invalid_argument if the number of teams is under 2, not a power of
+ *         2, or over MAX_TEAMS
  */
 void bracket::init(int _bracket_teams)
 {
     bracket_spots = 0;
-    if (_bracket_teams == 1 || !is_pow_two(_bracket_teams))
+    if (_bracket_teams < 2 || !is_pow_two(_bracket_teams))
         throw invalid_argument("Number of teams isn't power of two.");
-    
-    for (int temp_bracket_size = _bracket_teams / 2; temp_bracket_size > 1; temp_bracket_size /= 2)
-        bracket_spots += temp_bracket_size;
-    ++bracket_spots;
+    if (_bracket_teams > MAX_TEAMS)
+        throw invalid_argument("Too many teams for one bracket.");
 
-    bracket_gap = (2*(int)log2((bracket_spots+1)/2-1)+1) * SIZE_PAIR_PADDING; 
+    // Each game knocks out one team, and all but the champion are knocked out
+    bracket_spots = _bracket_teams - 1;
 
     create_tree();
+    reset_teams(_bracket_teams);
+    seed_slots.assign(_bracket_teams, -1);
+    champion = NO_TEAM;
 }
 
 
 /**
- * @brief private helper that creates the bracket team based on the number of
- *        bracket_spots
+ * @brief private helper that creates the bracket tree based on the number of
+ *        bracket_spots. The whole complete tree is one heap-ordered array of
+ *        empty (NONE vs NONE) nodes. Pages of the last tree that no copy
+ *        shares are refilled in place, so rebuilding a bracket reuses them.
  */
 void bracket::create_tree()
 {
-    root = new node();
-    create_tree(root, 0, log2(bracket_spots+1) - 1);
+    slots.assign(bracket_spots, node());
+}
+
+
+// Index arithmetic for the implicit, heap-ordered tree
+int  bracket::left_child(int _slot) const  { return 2*_slot + 1; }
+int  bracket::right_child(int _slot) const { return 2*_slot + 2; }
+int  bracket::parent(int _slot) const      { return (_slot - 1) / 2; }
+bool bracket::is_leaf(int _slot) const     { return left_child(_slot) >= bracket_spots; }
+
+
+// Destructor, pages and the team table are freed by their last owner
+bracket::~bracket()
+{
+    finish_compaction();
 }
 
 
 /**
- * @brief recursively creates a complete, balanced tree based on a maximum depth
+ * @brief private helper that makes an empty team table for a number of teams.
+ *        A table no copy shares that already has that many teams is emptied
+ *        in place instead, so the names of the next teams are written into the
+ *        memory of the last ones and a rebuild doesn't allocate per team.
  * 
- * @param _curr_root is the current node in the bracket
- * @param _curr_depth is the current depth down the tree
- * @param _max_depth is the max depth that the tree should be
+ * @param _num_teams is the number of teams in the table
  */
-void bracket::create_tree(node * _curr_root, int _curr_depth, int _max_depth)
+void bracket::reset_teams(int _num_teams)
 {
-    if (_curr_depth < _max_depth)
+    if (!teams || teams.use_count() > 1 || (int)teams->size() != _num_teams)
     {
-        _curr_root->set_left(new node());
-        _curr_root->set_right(new node());
-        create_tree(_curr_root->get_left(), _curr_depth + 1, _max_depth);
-        create_tree(_curr_root->get_right(), _curr_depth + 1, _max_depth);
+        teams = make_shared<vector<team>>(_num_teams);
+        return;
     }
+    for (team & curr_team : *teams)
+        curr_team.set_team("NONE", 0, 0, 0, 0);
 }
 
 
-// Destructor
-bracket::~bracket()
+/**
+ * @brief private helper that erases the bracket before it is rebuilt. The
+ *        pages of the tree and the team table are kept for the next bracket
+ *        (see create_tree() and reset_teams()).
+ */
+void bracket::erase()
 {
-    erase();
+    finish_compaction();
+    seed_slots.clear();
+    journal.clear();
+    saved_file.clear();
+    unsaved.clear();
+    log_edits     = 0;
+    rewrite       = true;
+    champion      = NO_TEAM;
+    bracket_spots = 0;
 }
 
 
 /**
- * @brief private helper that erases the tree
+ * @brief opens a file and copies the bracket from a file. The bracket must have
+ *        already been modified. Binary saves are read straight from a memory
+ *        mapping of the file, and then the edits in its edit log are replayed.
+ *        A text save is parsed and left as it is; the bracket has no unsaved
+ *        changes, but save_changes() saves it whole in the binary format, which
+ *        should go to a file of its own (see SAVED_EXTENSION).
+ * 
+ * @param _file_name is the name of the file that holds the modified bracket.
  */
-void bracket::erase()
+void bracket::fill_bracket(const string & _file_name)
 {
-    erase(root);
-    root          = nullptr;
-    bracket_spots = 0;
-    bracket_gap   = 0;
+    erase();
+
+    {
+        lock_guard<mutex> lock(saved_file_lock());
+        mapped_file       saved(_file_name);    // Whole file in memory
+
+        // Binary save
+        if (saved.size() >= sizeof(SAVED_MAGIC) &&
+            memcmp(saved.data(), SAVED_MAGIC, sizeof(SAVED_MAGIC)) == 0)
+        {
+            load_binary(saved.data(), saved.size());
+            replay_log(_file_name + ".log");
+            saved_file = _file_name;
+            rewrite    = false;
+            return;
+        }
+
+        // Text save
+        bracket_parser parser(saved.data(), saved.size());
+        fill_bracket(parser);
+        build_seed_index();
+    }
+    rewrite = false;
 }
 
 
 /**
- * @brief recursive private helper that erases the tree
+ * @brief copies the bracket from the bytes of a save held in memory, such as
+ *        one read out of a bracket store, in the binary or the text format.
+ *        The bracket has no file, so it has unsaved changes until it is saved
+ *        or mark_saved() is called.
  * 
- * @param _curr_root is the current root in the tree
+ * @param _bytes is the start of the save
+ * @param _size is the number of bytes in the save
+ * @throws invalid_argument if the bytes don't hold a whole, valid save
  */
-void bracket::erase(node * _curr_root)
+void bracket::fill_bracket(const char * _bytes, size_t _size)
 {
-    if (_curr_root)
+    erase();
+
+    // Binary save
+    if (_size >= sizeof(SAVED_MAGIC) && memcmp(_bytes, SAVED_MAGIC, sizeof(SAVED_MAGIC)) == 0)
     {
-        erase(_curr_root->get_left());
-        erase(_curr_root->get_right());
-        delete _curr_root;
+        load_binary(_bytes, _size);
+        return;
     }
+
+    // Text save
+    bracket_parser parser(_bytes, _size);
+    fill_bracket(parser);
+    build_seed_index();
 }
 
 
 /**
- * @brief opens a file and copies the bracket from a file. The bracket must have
- *        already been modified.
+ * @brief private helper that loads a bracket saved in the binary format. The
+ *        team table and slot array are fixed width, so they are copied over
+ *        without any parsing.
  * 
- * @param _file_name is the name of the file that holds the modified bracket.
+ * @param _bytes is the start of the saved bracket
+ * @param _size is the number of bytes in the saved bracket
+ * @throws invalid_argument if the save is the wrong version, size, or checksum,
+ *         or a team isn't at its seed or in a spot it couldn't have reached
  */
-void bracket::fill_bracket(const string & _file_name)
+void bracket::load_binary(const char * _bytes, size_t _size)
 {
-    ifstream        inFile;             // Input stream
+    saved_tables         tables;                // Header and tables of the save
+    const saved_header & header = tables.header;
 
-    // Open file
-    inFile.open(_file_name);
-    if (!inFile.is_open())
-        throw invalid_argument("ERROR: file does not exist");
+    read_saved_tables(_bytes, _size, tables);
+    if (checksum(tables.teams, _size - sizeof(header)) != header.checksum)
+        throw invalid_argument("Saved bracket is corrupt (checksum mismatch)");
 
-    erase();
-    fill_bracket(inFile, root);
-    bracket_gap = (2*(int)log2((bracket_spots+1)/2-1)+1) * SIZE_PAIR_PADDING; 
+    bracket_spots = header.num_teams - 1;
+    create_tree();
+    reset_teams(header.num_teams);
+
+    for (uint32_t i = 0; i < header.num_teams; ++i)
+    {
+        saved_team record;
+        memcpy(&record, tables.teams + i * sizeof(record), sizeof(record));
+        if (record.seed == 0)
+            continue;
+        if (record.seed != (int32_t)i + 1)
+            throw invalid_argument("Invalid seed in file.");
+        if (record.name_offset + (uint64_t)record.name_length > header.name_bytes)
+            throw invalid_argument("Saved bracket is corrupt (bad team name)");
+        (*teams)[i].set_team(string_view(tables.names + record.name_offset, record.name_length),
+            record.wins, record.losses, record.ties, record.seed);
+    }
+
+    // Slots are read from the first round up, so each team can be checked
+    // against the game below it that it had to win
+    seed_order order(header.num_teams);     // Seed at each first round position
+    for (int i = bracket_spots - 1; i >= 0; --i)
+    {
+        saved_slot record;
+        memcpy(&record, tables.slots + i * sizeof(record), sizeof(record));
+        team_id first  = record.first == SAVED_NO_TEAM ? NO_TEAM : record.first;
+        team_id second = record.second == SAVED_NO_TEAM ? NO_TEAM : record.second;
+
+        if (is_leaf(i) ? !seeded_game(order, i, first, second)
+            : !won_game(left_child(i), first) || !won_game(right_child(i), second))
+            throw invalid_argument("Invalid seed in file.");
+        slots.write(i).set_pair(first, second);
+    }
+
+    // Champion has to be one of the teams in the final
+    if (header.version >= 2 && header.champion != SAVED_NO_TEAM)
+    {
+        const pair<team_id, team_id> & final_spot = slots[0].get_pair();
+        if (header.champion >= header.num_teams ||
+            (header.champion != final_spot.first && header.champion != final_spot.second))
+            throw invalid_argument("Invalid seed in file.");
+        champion = header.champion;
+    }
 
-    inFile.close();
+    saved_checksum = header.checksum;
+    build_seed_index();
 }
 
 
 /**
- * @brief recursive helper that fills in the bracket with teams from a local file
+ * @brief private helper that checks a first round game of a loaded save holds
+ *        the two teams the seeding puts there (see fill_bracket()).
  * 
- * @param inFile is the file stream where data is incoming
- * @param _root is the current node of the tree where the current team will go
+ * @param _order is the seeding of the bracket
+ * @param _slot is the first round slot
+ * @param _first is the team in the first spot
+ * @param _second is the team in the second spot
+ * @return true if both teams are seeded into that game
  */
-void bracket::fill_bracket(ifstream & inFile, node *& _root)
+bool bracket::seeded_game(const seed_order & _order, int _slot, team_id _first,
+    team_id _second) const
 {
-    inFile.peek();
-    if (!inFile.eof())
-    {
-        pair<team, team> spot;
-        bool             has_children;
+    team_id seeded = _order.seed_at(2 * (_slot - bracket_spots / 2)) - 1;
+
+    return _first == seeded && _second == (team_id)bracket_spots - seeded &&
+        !(*teams)[_first].same_seed(0) && !(*teams)[_second].same_seed(0);
+}
+
+
+/**
+ * @brief private helper that checks a team of a loaded save is empty or one of
+ *        the two teams of the game it came from.
+ * 
+ * @param _slot is the slot of the game below the spot
+ * @param _id is the team in the spot
+ * @return true if the team could have won that game
+ */
+bool bracket::won_game(int _slot, team_id _id) const
+{
+    const pair<team_id, team_id> & below = slots[_slot].get_pair();
+
+    return _id == NO_TEAM || _id == below.first || _id == below.second;
+}
+
 
-        spot.first.read_team(inFile, ';');
-        inFile.ignore();
-        spot.second.read_team(inFile, ';');
-        inFile.ignore();
-        inFile >> has_children;
-        inFile.ignore();
+/**
+ * @brief private helper that replays the edit log of the save just loaded (see
+ *        saved_format.h). The edits are written straight into the slots and
+ *        the seed index is rebuilt once after. A log for a different save is
+ *        left over from a crash while compacting and is removed, and a record
+ *        cut short at the end is cut off so the next append lines up.
+ * 
+ * @param _log_file is the edit log of the save
+ * @throws invalid_argument if an edit is for a slot or team not in the bracket
+ */
+void bracket::replay_log(const string & _log_file)
+{
+    saved_log_header header;        // Header of the log
+    size_t           size;          // Bytes in the log
+    size_t           records = 0;   // Whole edits in the log
+    bool             stale;         // If the log is for a different save
+    error_code       err;
 
-        _root = new node(spot);
+    if (!filesystem::exists(_log_file, err))
+        return;
+    {
+        mapped_file log(_log_file);     // Whole log in memory
 
-        ++bracket_spots;
+        size  = log.size();
+        stale = size < sizeof(header);
+        if (!stale)
+        {
+            memcpy(&header, log.data(), sizeof(header));
+            stale = memcmp(header.magic, SAVED_LOG_MAGIC, sizeof(SAVED_LOG_MAGIC)) != 0 ||
+                header.version != SAVED_LOG_VERSION || header.base != saved_checksum;
+        }
+        if (!stale)
+            records = (size - sizeof(header)) / sizeof(saved_log_edit);
 
-        if (has_children)
+        for (size_t i = 0; i < records; ++i)
         {
-            fill_bracket(inFile, _root->get_left());
-            fill_bracket(inFile, _root->get_right());
+            saved_log_edit edit;
+            memcpy(&edit, log.data() + sizeof(header) + i * sizeof(edit), sizeof(edit));
+            if (edit.slot < -1 || edit.slot >= bracket_spots || edit.second > 1 ||
+                (edit.team != SAVED_NO_TEAM && edit.team >= (uint32_t)num_teams()))
+                throw invalid_argument("Saved bracket is corrupt (bad edit log)");
+
+            team_id put = edit.team == SAVED_NO_TEAM ? NO_TEAM : edit.team;
+            if (edit.slot < 0)
+                champion = put;
+            else if (edit.second)
+                slots.write(edit.slot).set_pair_second(put);
+            else
+                slots.write(edit.slot).set_pair_first(put);
         }
     }
+
+    if (stale)
+    {
+        filesystem::remove(_log_file, err);
+        return;
+    }
+    // Log ended in a torn record
+    if (size != sizeof(header) + records * sizeof(saved_log_edit))
+        filesystem::resize_file(_log_file, sizeof(header) + records * sizeof(saved_log_edit), err);
+    log_edits = records;
+    if (records > 0)
+        build_seed_index();
 }
 
 
 /**
- * @brief initializes bracket from data file using fstream
+ * @brief helper that reads the preorder dump of a bracket from a local file and
+ *        places every node into its heap-ordered slot. The dump starts down
+ *        the leftmost path of the tree, so the nodes up to the first matchup
+ *        without children give the depth of the tree. That lets the tree be
+ *        allocated once at its final size before the rest is read in place.
  * 
- * @param _file_name is the name of file for unmodified bracket
+ * @param _parser is the parser over the saved file
+ * @throws invalid_argument if the file doesn't hold a complete, balanced tree
  */
-void bracket::init_bracket(const string & _file_name)
+void bracket::fill_bracket(bracket_parser & _parser)
 {
-    ifstream      inFile;             // Input stream
-    stack<team>   unordered_teams;    // Teams from file
-    team**        ordered_teams;      // Teams from file in seed order
-    int           num_teams = 0;      // Number of teams from file
-    team          temp_team;
+    parsed_team leftmost[32][2];    // Nodes down the leftmost path of the tree
+    int         depth = 0;          // Number of nodes on the leftmost path
+    bool        has_children;
+
+    // Read down to the first round
+    do {
+        if (depth == 32)
+            throw parse_error(_parser.get_line(), 1, "a complete bracket (too deep)");
+        has_children = _parser.read_saved_node(leftmost[depth][0], leftmost[depth][1]);
+        ++depth;
+    } while (has_children);
+
+    if ((uint64_t)1 << depth > (uint64_t)MAX_TEAMS)
+        throw invalid_argument("Too many teams for one bracket.");
+    bracket_spots = (1 << depth) - 1;
+    create_tree();
+    reset_teams(bracket_spots + 1);
+
+    // Leftmost path sits at slots 0, 1, 3, 7, ...; then every right subtree
+    // follows in preorder from the bottom of the path back up to the final
+    for (int i = 0; i < depth; ++i)
+        slots.write((1 << i) - 1).set_pair(intern_team(leftmost[i][0]),
+            intern_team(leftmost[i][1]));
+    for (int i = depth - 2; i >= 0; --i)
+        fill_bracket(_parser, right_child((1 << i) - 1));
+
+    if (!_parser.at_end())
+        throw parse_error(_parser.get_line(), 1, "the end of the file (extra nodes)");
+}
 
-    // Open file
-    inFile.open(_file_name);
-    if (!inFile.is_open())
-        throw invalid_argument("File name doesn't exist");
 
-    // Read data into a stack
-    inFile.peek();
-    while (!inFile.eof() && !inFile.fail())
+/**
+ * @brief recursive helper that reads a subtree from a local file in preorder
+ *        straight into its heap-ordered slots.
+ * 
+ * @param _parser is the parser over the saved file
+ * @param _root is the current slot of the tree where the current node will go
+ * @throws invalid_argument if a saved node's children don't match the tree
+ */
+void bracket::fill_bracket(bracket_parser & _parser, int _root)
+{
+    parsed_team first, second;
+    int         line = _parser.get_line();
+
+    if (_parser.read_saved_node(first, second) == is_leaf(_root))
+        throw parse_error(line, 1, is_leaf(_root) ? "a first round node (no children)"
+            : "a node with children");
+    slots.write(_root).set_pair(intern_team(first), intern_team(second));
+
+    if (!is_leaf(_root))
     {
-        temp_team.read_team(inFile, ';');
-        inFile.ignore();
-        unordered_teams.push(temp_team);
-        ++num_teams;
+        fill_bracket(_parser, left_child(_root));
+        fill_bracket(_parser, right_child(_root));
     }
+}
+
+
+/**
+ * @brief adds a team read from a saved file to the team table. Teams are
+ *        interned by seed, so a team repeated at every round it reached is
+ *        only stored (and its name only copied) once.
+ * 
+ * @param _team is the team to intern
+ * @return team_id: the id of the team, or NO_TEAM for an empty (NONE) spot
+ * @throws invalid_argument if the seed doesn't fit in the bracket
+ */
+team_id bracket::intern_team(const parsed_team & _team)
+{
+    if (_team.school_name == "NONE")
+        return NO_TEAM;
+    if (_team.seed < 1 || _team.seed > (int)teams->size())
+        throw invalid_argument("Invalid seed in file.");
+
+    team_id id = _team.seed - 1;
+    if ((*teams)[id].same_seed(0))
+        (*teams)[id].set_team(_team.school_name, _team.wins, _team.losses,
+            _team.ties, _team.seed);
+    return id;
+}
+
 
-    // Error check bad input
-    if (!inFile.eof())
+/**
+ * @brief initializes bracket from data file using fstream
+ * 
+ * @param _file_name is the name of file for unmodified bracket
+ */
+void bracket::init_bracket(const string & _file_name)
+{
+    mapped_file                 division(_file_name);  // Whole file in memory
+    bracket_parser              parser(division.data(), division.size());
+    vector<parsed_team>         unordered_teams;       // Teams from file
+    vector<const parsed_team *> seeded_teams;          // Teams from file in seed order
+    int                         num_teams;             // Number of teams from file
+
+    // Read data into a list, sized up front from the lines in the file. The
+    // names point into the file, so none are copied until they are placed
+    unordered_teams.reserve(count(division.data(), division.data() + division.size(), '\n') + 1);
+    while (!parser.at_end())
     {
-        inFile.close();
-        throw invalid_argument("File formatted incorrectly (ensure no empty lines)");
+        unordered_teams.emplace_back();
+        parser.read_team(unordered_teams.back());
     }
-    inFile.close();
+    num_teams = unordered_teams.size();
 
     // Check if valid number of teams (2^x)
-    if (!is_pow_two(num_teams))
+    if (num_teams < 2 || !is_pow_two(num_teams))
         throw invalid_argument("Number of teams isn't power of two.");
+    if (num_teams > MAX_TEAMS)
+        throw invalid_argument("Too many teams for one bracket.");
 
-    // Initialize array of ordered teams
-    int array_size = num_teams * 2; // order_comp_teams() requires double size array
-    ordered_teams  = new team*[array_size];
-    for (int i = 0; i < array_size; ++i)
-        ordered_teams[i] = nullptr;
-
-    // Pop from stack into array based on seed number
-    for (int i = 0; i < num_teams; ++i)
+    // Point to each team by seed
+    seeded_teams.assign(num_teams, nullptr);
+    for (const parsed_team & curr_team : unordered_teams)
     {
-        team * curr_team = new team(unordered_teams.top());
         // Check if negative, or too large of a seed, or if a double up on a seed
-        if (curr_team->invalid_rank(num_teams) ||
-            ordered_teams[curr_team->get_seed() - 1])
-        {
-            // Clean up added teams before throw
-            for (int i = 0; i < num_teams; ++i)
-                if (ordered_teams[i])
-                    delete ordered_teams[i];
-            delete ordered_teams;
+        if (curr_team.seed < 1 || curr_team.seed > num_teams ||
+            seeded_teams[curr_team.seed - 1])
             throw invalid_argument("Invalid seed in file.");
-        }
-        // Place team in array, remove from stack
-        ordered_teams[curr_team->get_seed() - 1] = curr_team;
-        unordered_teams.pop();
+        seeded_teams[curr_team.seed - 1] = &curr_team;
     }
 
-    // Order teams based on seeded matchups (1v32, 2v31, ...) and place into tree
-    ordered_teams = order_comp_bracket(ordered_teams, num_teams);
-    fill_bracket(ordered_teams, num_teams);
-
-    // Delete all elements from array
-    for (int i = 0; i < num_teams; ++i)
-        if (ordered_teams[i])
-            delete ordered_teams[i];
-    delete [] ordered_teams;
+    // Place teams into tree in seeded matchups (1v32, 16v17, ...)
+    fill_bracket(seeded_teams.data(), num_teams);
 }
 
 
 /**
- * @brief sorts teams into a seeded matchup order
+ * @brief private helper that fills the first round with teams in the seeded
+ *        matchup order. The seed at each first round position is worked out
+ *        in closed form (see seed_order.h), so teams go straight from seed
+ *        order into their slots.
  * 
- * @param _ordered_teams is teams in a low-high sort based on seed
- * @param _size is the number of teams
- * @return team **: the teams in the seeded matchup order
+ * @param _seeded_teams is the teams in seed order, each is copied into the
+ *        team table
+ * @param _num_teams is the number of teams
  */
-team ** bracket::order_comp_bracket(team ** _ordered_teams, int _size)
+void bracket::fill_bracket(const parsed_team ** _seeded_teams, int _num_teams)
 {
-    int group_size = 1;    // How many teams are shifting
-    int i, target_index;   // Iterators
-    while (group_size < _size / 2)
+    seed_order order(_num_teams);   // Seed at each first round position
+
+    // Reset bracket
+    erase();
+    init(_num_teams);
+
+    // First round matchups are the last slots of the array, left to right,
+    // and the two seeds of a game always add up to teams + 1
+    for (int i = bracket_spots / 2, position = 0; i < bracket_spots; ++i, position += 2)
     {
-        // Space groups apart
-        target_index = _size*2 - 1 - group_size; // End of expanded array
-        i = _size - 1;                           // End of normal array
-        while (i > group_size - 1)
-        {
-            for (int j = 0; j < group_size; ++j) // Moving each group
-            {
-                _ordered_teams[target_index] = _ordered_teams[i];
-                _ordered_teams[i] = nullptr;
-                --target_index;
-                --i;
-            }
-            target_index -= group_size;
-        }
+        team_id first  = order.seed_at(position) - 1;
+        team_id second = _num_teams - 1 - first;
+
+        for (team_id id : {first, second})
+            (*teams)[id].set_team(_seeded_teams[id]->school_name, _seeded_teams[id]->wins,
+                _seeded_teams[id]->losses, _seeded_teams[id]->ties, _seeded_teams[id]->seed);
+        slots.write(i).set_pair(first, second);
+        seed_slots.write(first)  = i;
+        seed_slots.write(second) = i;
+    }
+}
+
+
+/**
+ * @brief saves the modified bracket to a filename in the binary format. The
+ *        bracket is written to a temporary file first and moved over the old
+ *        save, so a failed save never leaves a half written file behind.
+ * 
+ * @param _file_name is the file to save the data to
+ */
+void bracket::save_bracket(const string & _file_name) const
+{
+    uint64_t saved;     // Checksum of the save, not needed
+
+    write_save(_file_name, saved);
+}
+
 
-        // Recombine groups
-        target_index = _size*2 - 1 - group_size; // End of expanded array
-        i = group_size;                          // Startish of array
-        while (i < _size)
+/**
+ * @brief saves only what changed since the bracket was loaded from or saved to
+ *        the file. Nothing is written if nothing changed. Otherwise the spots
+ *        written since are appended to the file's edit log, which is folded
+ *        back into the save on a background thread once it has grown to a
+ *        quarter of the bracket. A bracket that was loaded from a different
+ *        file, rebuilt, or copied, or whose save was removed, is saved whole.
+ * 
+ * @param _file_name is the file to save the data to
+ */
+void bracket::save_changes(const string & _file_name)
+{
+    error_code err;     // Ignored, a missing save is saved whole
+
+    finish_compaction();
+    if (!rewrite && _file_name == saved_file && filesystem::exists(_file_name, err))
+    {
+        if (unsaved.empty())
+            return;
+        if (append_log(_file_name + ".log"))
         {
-            for (int j = 0; j < group_size; ++j) // Moving each group
+            log_edits += unsaved.size();
+            unsaved.clear();
+            if (log_edits >= (size_t)max(LOG_MIN_EDITS, bracket_spots / 4))
             {
-                _ordered_teams[i] = _ordered_teams[target_index];
-                _ordered_teams[target_index] = nullptr;
-                --target_index;
-                ++i;
+                // The copy is released here, not on the thread, so pages are
+                // only ever let go of by this thread
+                compacting = make_shared<const bracket>(*this);
+                compaction = async(launch::async, [copy = compacting.get(), _file_name]()
+                {
+                    uint64_t saved;
+                    bool     written = copy->write_save(_file_name, saved, true);
+                    return make_pair(written, saved);
+                });
             }
-            target_index -= group_size;
-            i += group_size;
+            return;
         }
-        group_size *= 2;
     }
-    return _ordered_teams;
+
+    rewrite    = !write_save(_file_name, saved_checksum);
+    saved_file = _file_name;
+    log_edits  = 0;
+    unsaved.clear();
+}
+
+
+/**
+ * @brief marks the bracket as the same as a save made or read some other way
+ *        than save_changes() or fill_bracket() (such as by a bracket store),
+ *        so it has no unsaved changes until its next edit. The next
+ *        save_changes() still writes the whole bracket.
+ */
+void bracket::mark_saved()
+{
+    finish_compaction();
+    saved_file.clear();
+    unsaved.clear();
+    log_edits = 0;
+    rewrite   = false;
 }
 
 
 /**
- * @brief private helper that fills the bracket based on the competition ordered
- *        teams.
+ * @brief Checks if the bracket changed since it was loaded or saved
  * 
- * @param _comp_ordered_teams is the teams in an order after order_comp_bracket()
- * @param _num_teams is the number of teams
+ * @return true if save_changes() has anything to write
+ * @return false if the save on file is the same as the bracket
  */
-void bracket::fill_bracket(team ** _comp_ordered_teams, int _num_teams)
+bool bracket::has_unsaved_changes() const
 {
-    int curr_index = 0;     // Requires referenced int
+    return rewrite || !unsaved.empty();
+}
 
-    // Reset bracket
-    erase();
-    init(_num_teams);
 
-    // Fill bracket from array
-    fill_bracket(root, _comp_ordered_teams, curr_index);
+/**
+ * @brief waits for the edit log to be folded into the save, if it is being,
+ *        and picks up the new save's checksum. If folding failed the old save
+ *        and its log are both still in place.
+ */
+void bracket::finish_compaction()
+{
+    if (!compaction.valid())
+        return;
+
+    pair<bool, uint64_t> folded(false, 0);     // If folded, and new checksum
+    try {
+        folded = compaction.get();
+    } catch (...) {}
+    if (folded.first)
+    {
+        saved_checksum = folded.second;
+        log_edits      = 0;
+    }
+    compacting.reset();
 }
 
 
 /**
- * @brief recursive helper that fills the bracket based on the competition
- *        ordered teams.
+ * @brief private helper that saves the bracket whole in the binary format and
+ *        drops the save's edit log, which the save now includes.
  * 
- * @param _root is the current node to be filled with a matchup
- * @param _comp_ordered_teams is the array of ordered teams
- * @param _curr_index is the current index in the teams array
+ * @param _file_name is the file to save the data to
+ * @param _checksum is set to the checksum of the save
+ * @param _replace_only is true to only write over a save that still exists,
+ *        so folding a log into a save that was removed meanwhile doesn't bring
+ *        it back
+ * @return true if the save was written
+ * @return false if it couldn't be, the old save and its log are left alone
  */
-void bracket::fill_bracket(node * _root, team ** _comp_ordered_teams,
-    int & _curr_index)
+bool bracket::write_save(const string & _file_name, uint64_t & _checksum,
+    bool _replace_only) const
 {
-    // Adds teams from array if at child
-    if (!_root->get_left() && !_root->get_right())
+    ofstream   outFile;                         // File ostream
+    string     buffer;                          // Bytes of the save
+    string     temp_file = _file_name + ".tmp"; // File written before the move
+    error_code err;                             // Ignored, save is best effort
+    saved_header header;
+
+    write_binary(buffer);
+    memcpy(&header, buffer.data(), sizeof(header));
+    _checksum = header.checksum;
+    outFile.open(temp_file, std::ofstream::out | std::ofstream::trunc |
+        std::ofstream::binary);
+    outFile.write(buffer.data(), buffer.size());
+    outFile.close();
+
+    if (outFile.fail())
+    {
+        filesystem::remove(temp_file, err);
+        return false;
+    }
+
+    lock_guard<mutex> lock(saved_file_lock());
+    if (_replace_only && !filesystem::exists(_file_name, err))
     {
-        _root->set_pair(*_comp_ordered_teams[_curr_index], *_comp_ordered_teams[_curr_index + 1]);
-        _curr_index += 2;
+        filesystem::remove(temp_file, err);
+        return false;
     }
-    else
+    filesystem::rename(temp_file, _file_name, err);
+    if (err)
     {
-        fill_bracket(_root->get_left(), _comp_ordered_teams, _curr_index);
-        fill_bracket(_root->get_right(), _comp_ordered_teams, _curr_index);
+        filesystem::remove(temp_file, err);
+        return false;
     }
+    filesystem::remove(_file_name + ".log", err);
+    return true;
 }
 
 
 /**
- * @brief saves the modified bracket to a filename
+ * @brief private helper that appends the spots written since the last save to
+ *        the edit log, starting a new log if there are no edits logged yet.
  * 
- * @param _file_name is the file to save the data to
+ * @param _log_file is the edit log of the save
+ * @return true if the edits were appended
+ * @return false if the log couldn't be written
  */
-void bracket::save_bracket(const string & _file_name) const
+bool bracket::append_log(const string & _log_file) const
 {
-    ofstream outFile;   // File ostream
+    lock_guard<mutex> lock(saved_file_lock());
+    ofstream          outFile;  // File ostream
 
-    outFile.open(_file_name, std::ofstream::out | std::ofstream::trunc);
-    save_bracket(outFile, root);
+    if (log_edits == 0)
+    {
+        saved_log_header header;
+        memcpy(header.magic, SAVED_LOG_MAGIC, sizeof(SAVED_LOG_MAGIC));
+        header.version = SAVED_LOG_VERSION;
+        header.base    = saved_checksum;
+        outFile.open(_log_file, std::ofstream::out | std::ofstream::trunc |
+            std::ofstream::binary);
+        outFile.write((const char *)&header, sizeof(header));
+    }
+    else
+        outFile.open(_log_file, std::ofstream::out | std::ofstream::app |
+            std::ofstream::binary);
+    for (const auto & spot : unsaved)
+    {
+        team_id        now    = spot.second.second;
+        saved_log_edit record = {(int32_t)(spot.first / 2) - 1,
+            (uint32_t)(spot.first % 2), now == NO_TEAM ? SAVED_NO_TEAM : now};
+        outFile.write((const char *)&record, sizeof(record));
+    }
     outFile.close();
+    return !outFile.fail();
 }
 
 
 /**
- * @brief recursively saves the modified bracket to the output stream 
+ * @brief lays out the bracket in the binary save format, see saved_format.h
  * 
- * @param outFile is the output stream being saved to
- * @param _root is the current node being saved from
+ * @param _buffer is filled with the bytes of the save
  */
-void bracket::save_bracket(ofstream & outFile, node * _root) const
+void bracket::write_binary(string & _buffer) const
 {
-    if (_root)
+    const vector<team> & table = *teams;    // Team table
+    saved_header         header;            // Header of the save
+    size_t               names_start;       // Offset of the school names
+    uint32_t             name_bytes = 0;
+
+    memcpy(header.magic, SAVED_MAGIC, sizeof(SAVED_MAGIC));
+    header.version   = SAVED_VERSION;
+    header.num_teams = table.size();
+    header.champion  = champion == NO_TEAM ? SAVED_NO_TEAM : champion;
+    header.reserved  = 0;
+
+    names_start = sizeof(header) + table.size() * sizeof(saved_team) +
+        bracket_spots * sizeof(saved_slot);
+    _buffer.assign(names_start, '\0');
+
+    for (size_t i = 0; i < table.size(); ++i)
     {
-        if (_root != this->root)
-            outFile << '\n';
-        _root->get_pair().first.print_for_file(outFile);
-        outFile << ';';
-        _root->get_pair().second.print_for_file(outFile);
-        outFile << ';';
-
-        if (_root->get_left())
-        {
-            outFile << "1";
-            save_bracket(outFile, _root->get_left());
-            save_bracket(outFile, _root->get_right());
-        }
-        else
-            outFile << "0";
+        saved_team record;
+        record.name_offset = name_bytes;
+        record.name_length = table[i].get_name().size();
+        record.wins        = table[i].get_wins();
+        record.losses      = table[i].get_losses();
+        record.ties        = table[i].get_ties();
+        record.seed        = table[i].get_seed();
+        memcpy(&_buffer[sizeof(header) + i * sizeof(record)], &record, sizeof(record));
+
+        _buffer.append(table[i].get_name());
+        if (name_bytes + (uint64_t)record.name_length > UINT32_MAX)
+            throw invalid_argument("School names are too long to save.");
+        name_bytes += record.name_length;
+    }
+
+    for (int i = 0; i < bracket_spots; ++i)
+    {
+        const pair<team_id, team_id> & spot = slots[i].get_pair();
+        saved_slot record;
+        record.first  = spot.first == NO_TEAM ? SAVED_NO_TEAM : spot.first;
+        record.second = spot.second == NO_TEAM ? SAVED_NO_TEAM : spot.second;
+        memcpy(&_buffer[sizeof(header) + table.size() * sizeof(saved_team) +
+            i * sizeof(record)], &record, sizeof(record));
     }
+
+    header.name_bytes = name_bytes;
+    header.checksum   = checksum(_buffer.data() + sizeof(header),
+        _buffer.size() - sizeof(header));
+    memcpy(&_buffer[0], &header, sizeof(header));
 }
 
 
 /**
- * @brief draws the bracket on the screen with a header and all teams
+ * @brief saves the modified bracket to a filename in the older preorder text
+ *        format. Format of each line is below...
+ * FORMAT: FIRST_TEAM;SECOND_TEAM;HAS_CHILDREN
+ * 
+ * @param _file_name is the file to save the data to
  */
-void bracket::draw() const                                                        
+void bracket::save_bracket_text(const string & _file_name) const
 {
-    int max_depth = log2(bracket_spots + 1) - 1;    // Max depth of tree
-    int num_columns = max_depth*2 + 1;              // Number of columns for bracket
-    int center_column = num_columns / 2;            // Position of center column
-
-    // Draw header for bracket
-    for (int i = 0; i < num_columns; ++i)
-    {
-        if (i == center_column - 2 || i == center_column + 2)
-            cout << left << setw(18) << setfill(' ') << "QUARTERFINALS";
-        else if (i == center_column - 1 || i == center_column + 1)
-            cout << left << setw(18) << setfill(' ') << "SEMIFINALS";
-        else if (i == center_column)
-            cout << left << setw(18) << setfill(' ') << "FINAL";
-        else if (i < center_column)
-            cout << left << "ROUND: " << setw(11) << setfill(' ') << i + 1;
-        else
-            cout << left << "ROUND: " << setw(11) << setfill(' ') 
-                 << num_columns - i;
-    }
-    cout << endl << setw(num_columns * 18 - 2) << setfill('=') << '=' << endl;
+    ofstream outFile;   // File ostream
 
-    // Draw full bracket and finals spot
-    max_depth = 0;
-    draw(root->get_left(), root->get_right(), 0, max_depth);
-    draw_pair(root->get_pair(), bracket_gap/2 + SIZE_PAIR_PADDING/2);
+    outFile.open(_file_name, std::ofstream::out | std::ofstream::trunc);
+    if (bracket_spots > 0)
+        save_bracket(outFile, 0);
+    outFile.close();
 }
 
 
 /**
- * @brief recursively draws the bracket going down the root's left tree and right
- *        tree simultaneously
+ * @brief recursively saves the modified bracket to the output stream in
+ *        preorder
  * 
- * @param _left_root is the left tree's current node to print
- * @param _right_root is the right tree's current node to print
- * @param _curr_depth is the current depth in the tree
- * @param _max_depth is the current maximum depth of the tree
+ * @param outFile is the output stream being saved to
+ * @param _root is the current slot being saved from
  */
-void bracket::draw(node * _left_root, node * _right_root, int _curr_depth,
-    int & _max_depth) const
+void bracket::save_bracket(ofstream & outFile, int _root) const
 {
-    if (_left_root)
+    if (_root != 0)
+        outFile << '\n';
+    get_team(slots[_root].get_pair().first).print_for_file(outFile);
+    outFile << ';';
+    get_team(slots[_root].get_pair().second).print_for_file(outFile);
+    outFile << ';';
+
+    if (!is_leaf(_root))
     {
-        if (_curr_depth > _max_depth)
-            _max_depth = _curr_depth;
-        draw(_left_root->get_left(), _right_root->get_left(), _curr_depth + 1,
-            _max_depth);
-        draw_pairs(_left_root->get_pair(), _right_root->get_pair(),
-            (_max_depth-_curr_depth) * SIZE_PAIR_PADDING);
-        draw(_left_root->get_right(), _right_root->get_right(), _curr_depth + 1,
-            _max_depth);
+        outFile << "1";
+        save_bracket(outFile, left_child(_root));
+        save_bracket(outFile, right_child(_root));
     }
+    else
+        outFile << "0";
+}
+
+
+/**
+ * @brief draws the bracket on the screen with a header and all teams
+ */
+void bracket::draw() const
+{
+    draw(cout);
 }
 
 
 /**
- * @brief draws two mirrored playoff matchups on opposite sides of the screen
+ * @brief draws the bracket to a stream with a header and all teams. The whole
+ *        bracket is laid out first and written at once (see bracket_renderer).
  * 
- * @param _left_spot is the left matchup to print
- * @param _right_spot is the right matchup to print
- * @param _left_padding is the padding to the left of the left matchup
+ * @param _out is the stream to draw to
  */
-void bracket::draw_pairs(const pair<team, team> & _left_spot, 
-                         const pair<team, team> & _right_spot, 
-                         int _left_padding) const
+void bracket::draw(ostream & _out) const
 {
-    int right_padding = bracket_gap - (2*_left_padding);    // Padding between current spots
-    
-    // First team in matchup on left
-    for (int i = 0; i < _left_padding; ++i)
-        cout << ' ';
-    cout << "|";
-    if (!_left_spot.first.same_name("NONE"))
-        _left_spot.first.display_in_bracket();
-    else
-        cout << "---------------";
-    cout << "|";
-    for (int i = 0; i < right_padding; ++i)
-        cout << ' ';
-    // First team in matchup on right
-    cout << "|";
-    if (!_right_spot.first.same_name("NONE"))
-        _right_spot.first.display_in_bracket();
-    else
-        cout << "---------------";
-    cout << "|\n";
-
-    // Second team in matchup on left
-    for (int i = 0; i < _left_padding; ++i)
-        cout << ' ';
-    cout << "|";
-    if (!_left_spot.second.same_name("NONE"))
-        _left_spot.second.display_in_bracket();
-    else
-        cout << "---------------";
-    cout << "|";
-    for (int i = 0; i < right_padding; ++i)
-        cout << ' ';
-    // Second team in matchup on right
-    cout << "|";
-    if (!_right_spot.second.same_name("NONE"))
-        _right_spot.second.display_in_bracket();
-    else
-        cout << "---------------";
-    cout << "|\n";
+    bracket_renderer(*this).draw(_out);
 }
 
 
 /**
- * @brief draws one matchup (bracket spot)
+ * @brief draws the bracket into a string with a header and all teams
  * 
- * @param spot is the matchup to print
- * @param _left_padding is the padding to the left of the matchup
+ * @param _out is filled with the drawn bracket
  */
-void bracket::draw_pair(const pair<team, team> & _spot, 
-                        int _left_padding) const
+void bracket::draw(string & _out) const
 {
-    // First team in matchup
-    for (int i = 0; i < _left_padding; ++i)
-        cout << ' ';
-    cout << "|";
-    if (!_spot.first.same_name("NONE"))
-        _spot.first.display_in_bracket();
-    else
-        cout << "---------------";
-    cout << "|\n";
-
-    // Second team in matchup
-    for (int i = 0; i < _left_padding; ++i)
-        cout << ' ';
-    cout << "|";
-    if (!_spot.second.same_name("NONE"))
-        _spot.second.display_in_bracket();
-    else
-        cout << "---------------";
-    cout << "|" << endl;
+    bracket_renderer(*this).render(_out);
 }
 
 
@@ -588,7 +929,7 @@ void bracket::user_advance_winner()
     cout << "Which team would you like to advance (team seed)? ";
     team_rank = integer_input(std::cin, "Please enter a valid seed: ", 1);
 
-    found = search_and_decide(team_rank);
+    found = advance_team(team_rank);
     if (!found)
         cout << "Team is out of the playoffs or doesn't exist." << endl;
     else
@@ -597,93 +938,417 @@ void bracket::user_advance_winner()
 
 
 /**
- * @brief a wrapper to search the bracket for a team to advance
+ * @brief advances a team one round by its seed. Will not advance the team if...
+ *        (1) the seed does not exist
+ *        (2) the seed was out of the running
+ *        (3) the seed currently has no matchup
  * 
- * @param _rank is the rank of the team to search for
- * @return true if the team has been advanced
+ * @param _seed is the seed of the team to advance
+ * @return true if the team has been advanced (or has no matchup yet)
  * @return false if the team has not been found or cannot be advanced
  */
-bool bracket::search_and_decide(int _rank)
+bool bracket::advance_team(int _seed)
 {
-    return search_and_decide(root, nullptr, 'X', _rank);
+    return search_and_decide(_seed);
 }
 
 
 /**
- * @brief searches the bracket for a team to advance. Will not advance the team if...
+ * @brief looks up the slot a team has advanced furthest to and decides its
+ *        game. The lookup goes through the seed index, so no search of the tree
+ *        is needed. Will not advance the team if...
  *        (1) the rank does not exist
  *        (2) the rank was out of the running
  *        (3) the rank currently has no matchup
  * 
- * @param _root is the current node to look for the team
- * @param _parent is where the team would be advanced to
- * @param _dir (L/R) which direction was just traveled
- * @param _rank is the rank to look for
+ * @param _rank is the rank of the team to search for
  * @return true if the team had been advanced
  * @return false if the team has not been found or cannot be advanced
  */
-bool bracket::search_and_decide(node * _root, node * _parent, char _dir, int _rank)
+bool bracket::search_and_decide(int _rank)
+{
+    team_id id;             // Id of the team to advance
+    int     slot;           // Slot the team has advanced furthest to
+    int     target = -1;    // Slot the team would be advanced to
+    char    dir    = 'X';   // Side of the target slot
+
+    if (_rank < 1 || _rank > (int)seed_slots.size() || seed_slots[_rank - 1] < 0)
+        return false;
+    id   = _rank - 1;
+    slot = seed_slots[id];
+
+    const pair<team_id, team_id> & spot = slots[slot].get_pair();
+
+    // Team is out of the running if its game already has a winner
+    if (slot != 0)
+    {
+        target = parent(slot);
+        dir    = slot == left_child(target) ? 'L' : 'R';
+        const pair<team_id, team_id> & next = slots[target].get_pair();
+        if ((dir == 'L' ? next.first : next.second) != NO_TEAM)
+            return false;
+    }
+    else if (champion != NO_TEAM)
+        return champion == id;
+
+    // Team has no matchup yet
+    if (spot.first == NO_TEAM || spot.second == NO_TEAM)
+        return true;
+
+    advance_winner(id, target, dir);
+    return true;
+}
+
+
+/**
+ * @brief rebuilds the seed index by recording, for each team, the slot closest
+ *        to the final that holds the team. Slots are scanned from the first
+ *        round up, so the last slot recorded for a team is its furthest one.
+ */
+void bracket::build_seed_index()
+{
+    seed_slots.assign(teams->size(), -1);
+    for (int i = bracket_spots - 1; i >= 0; --i)
+    {
+        const pair<team_id, team_id> & spot = slots[i].get_pair();
+        if (spot.first != NO_TEAM)
+            seed_slots.write(spot.first) = i;
+        if (spot.second != NO_TEAM)
+            seed_slots.write(spot.second) = i;
+    }
+}
+
+
+/**
+ * @brief returns a slot of the heap-ordered tree. The children of slot i are
+ *        2i+1 and 2i+2, and the first round is the last num_teams()/2 slots.
+ * 
+ * @param _slot is the slot to get (0 is the final)
+ * @return const node &: the matchup in the slot
+ */
+const node & bracket::get_slot(int _slot) const
+{
+    return slots[_slot];
+}
+
+
+/**
+ * @brief Returns the slot a team has advanced furthest to, from the seed index.
+ * 
+ * @param _id is the id of the team
+ * @return int: the slot, or -1 if the team isn't in the bracket
+ */
+int bracket::team_slot(team_id _id) const
+{
+    if (_id >= seed_slots.size())
+        return -1;
+    return seed_slots[_id];
+}
+
+
+/**
+ * @brief Returns the number of teams in the bracket.
+ * 
+ * @return int: the number of teams
+ */
+int bracket::num_teams() const
+{
+    return bracket_spots + 1;
+}
+
+
+/**
+ * @brief Returns the number of rounds of games, including the final.
+ * 
+ * @return int: the number of rounds
+ */
+int bracket::num_rounds() const
+{
+    return floor_log2(num_teams());
+}
+
+
+/**
+ * @brief Returns the round a slot is played in. A slot's depth in the tree is
+ *        the highest set bit of slot + 1 (slot 0 is the final, slots 1-2 the
+ *        semifinals, 3-6 the quarterfinals...).
+ * 
+ * @param _slot is the slot (0 is the final)
+ * @return int: the round, counting up from the first round (0)
+ */
+int bracket::slot_round(int _slot) const
+{
+    return num_rounds() - 1 - floor_log2(_slot + 1);
+}
+
+
+/**
+ * @brief Returns the first slot of a round. The games of a round are one level
+ *        of the tree, from slot 2^(rounds-1-round) - 1 on.
+ * 
+ * @param _round is the round, counting up from the first round (0)
+ * @return int: the slot of the round's first (top) game
+ */
+int bracket::round_first_slot(int _round) const
+{
+    return (1 << (num_rounds() - 1 - _round)) - 1;
+}
+
+
+/**
+ * @brief Returns the label for a round as printed in the header of draw().
+ *        EXAMPLE (32 teams): ROUND: 1, ROUND: 2, QUARTERFINALS, SEMIFINALS, FINAL
+ * 
+ * @param _round is the round counting up from the first round (0)
+ * @return string: the round label
+ */
+string bracket::round_name(int _round) const
+{
+    int from_final = num_rounds() - 1 - _round;    // Rounds until the final
+
+    if (from_final == 0)
+        return "FINAL";
+    else if (from_final == 1)
+        return "SEMIFINALS";
+    else if (from_final == 2)
+        return "QUARTERFINALS";
+    return "ROUND: " + to_string(_round + 1);
+}
+
+
+/**
+ * @brief returns a team from the team table
+ * 
+ * @param _id is the id of the team
+ * @return const team &: the team, or an empty (NONE) team for NO_TEAM
+ */
+const team & bracket::get_team(team_id _id) const
+{
+    static const team none;     // Empty bracket spot
+
+    return _id == NO_TEAM ? none : (*teams)[_id];
+}
+
+
+/**
+ * @brief Returns the winner of the final.
+ * 
+ * @return team_id: the champion, or NO_TEAM if the final isn't decided
+ */
+team_id bracket::get_champion() const
+{
+    return champion;
+}
+
+
+/**
+ * @brief packs the winner of every game into one bit per game. The winner of
+ *        a game sits in its parent slot (or is the champion for the final), so
+ *        the bit only says which side of the game it came from.
+ * 
+ * @return bracket_picks: the picks of the bracket
+ */
+bracket_picks bracket::get_picks() const
 {
-    if (_root)
+    bracket_picks picks(num_teams());   // Picks of every game
+
+    for (int i = 0; i < bracket_spots; ++i)
     {
-        bool found_left    = false;
-        bool found_right   = false;
-        team first         = _root->get_pair().first;
-        team second        = _root->get_pair().second;
-        bool first_exists  = !first.same_name("NONE");
-        bool second_exists = !second.same_name("NONE");
-
-        // Check if playoff spot has at least 1 team in it
-        if (first_exists || second_exists)
+        const pair<team_id, team_id> & spot = slots[i].get_pair();
+        team_id winner = champion;
+
+        if (i != 0)
         {
-            // Determine if/where the found team is
-            if (first_exists && first.same_seed(_rank))
-                found_left = true;
-            else if (second_exists && second.same_seed(_rank))
-                found_right = true;
-
-            // Determine where to continue search/decide winner
-            if (first_exists && second_exists)
-            {
-                if (found_left)
-                   advance_winner(first, _parent, _dir);
-                else if (found_right)
-                   advance_winner(second, _parent, _dir);
-            }
-            else if (first_exists && !found_left)
-                found_right = search_and_decide(_root->get_right(), _root, 'R', _rank);
-            else if (second_exists && !found_right)
-                found_left  = search_and_decide(_root->get_left(), _root, 'L', _rank);
+            const pair<team_id, team_id> & next = slots[parent(i)].get_pair();
+            winner = i == left_child(parent(i)) ? next.first : next.second;
         }
-        // Empty spot, continue left and right
-        else
+        if (winner != NO_TEAM)
+            picks.set_winner(i, winner == spot.second);
+    }
+    return picks;
+}
+
+
+/**
+ * @brief replaces every game after the first round with the winners in the
+ *        picks. The first round is kept, so the picks are played up from the
+ *        bracket's own seeding.
+ * 
+ * @param _picks is the winner of every decided game
+ * @throws invalid_argument if the picks are for a different size of bracket,
+ *         or pick a winner for a game that can't have its matchup yet
+ */
+void bracket::set_picks(const bracket_picks & _picks)
+{
+    if (_picks.num_teams() != num_teams())
+        throw invalid_argument("Picks are for different sized brackets.");
+
+    // A game can only be decided once both games feeding it are
+    for (int i = 0; i < bracket_spots; ++i)
+    {
+        if (!_picks.is_decided(i))
+            continue;
+        if (is_leaf(i))
         {
-            found_left  = search_and_decide(_root->get_left(), _root, 'L', _rank);
-            if (!found_left)
-                found_right = search_and_decide(_root->get_right(), _root, 'R', _rank);
+            const pair<team_id, team_id> & spot = slots[i].get_pair();
+            if (spot.first == NO_TEAM || spot.second == NO_TEAM)
+                throw invalid_argument("Picks decide a game without a matchup.");
         }
-        return found_left || found_right;
+        else if (!_picks.is_decided(left_child(i)) || !_picks.is_decided(right_child(i)))
+            throw invalid_argument("Picks decide a game without a matchup.");
     }
-    else
-        return false;
+
+    // Not logged either, the next save writes the whole bracket
+    rewrite = true;
+    unsaved.clear();
+    for (int i = 0; i < bracket_spots / 2; ++i)
+        slots.write(i).set_pair(NO_TEAM, NO_TEAM);
+    champion = NO_TEAM;
+
+    // Play the games from the first round up to the final
+    for (int i = bracket_spots - 1; i >= 0; --i)
+    {
+        if (!_picks.is_decided(i))
+            continue;
+        const pair<team_id, team_id> & spot = slots[i].get_pair();
+        team_id winner = _picks.second_won(i) ? spot.second : spot.first;
+
+        // Not journaled, the picks replace the whole bracket
+        if (i == 0)
+            write_spot({-1, false, NO_TEAM, winner}, true);
+        else
+            write_spot({parent(i), i == right_child(parent(i)), NO_TEAM, winner}, true);
+    }
+    build_seed_index();
+    journal.clear();
 }
 
 
 /**
- * @brief adds the team to the advancement position
+ * @brief adds the team to the advancement position, and records the write in
+ *        the journal so it can be undone
  * 
- * @param _winner is the team to advance
- * @param _parent is the bracket spot to advance to
+ * @param _winner is the id of the team to advance
+ * @param _parent is the bracket slot to advance to (-1 for none)
  * @param _dir is the position in the spot to move the team to
  */
-void bracket::advance_winner(const team & _winner, node * _parent, char _dir)
+void bracket::advance_winner(team_id _winner, int _parent, char _dir)
 {
-    // Case for if the final game
-    if (!_parent)
-        return;
+    slot_edit edit = {_parent, _dir == 'R', champion, _winner};
 
-    if (_dir == 'L')
-        _parent->set_pair_first(_winner);
+    if (_parent >= 0)
+    {
+        const pair<team_id, team_id> & spot = slots[_parent].get_pair();
+        edit.old_team = edit.second ? spot.second : spot.first;
+    }
+    journal.record(edit);
+    write_spot(edit, true);
+}
+
+
+// private helper that gives each spot its own key, the champion's included
+uint64_t bracket::spot_key(int _slot, bool _second)
+{
+    return (uint64_t)(_slot + 1) * 2 + _second;
+}
+
+
+/**
+ * @brief private helper that makes or reverts one write to a slot. The seed
+ *        index follows the team that was written: made, it has advanced to the
+ *        slot; reverted, it is back in the game it came from. Either way the
+ *        spot's change from its save is kept for the next save_changes().
+ * 
+ * @param _edit is the write
+ * @param _forward is true to make the write, false to revert it
+ */
+void bracket::write_spot(const slot_edit & _edit, bool _forward)
+{
+    team_id put   = _forward ? _edit.new_team : _edit.old_team;
+    team_id taken = _forward ? _edit.old_team : _edit.new_team;
+    int     child = _edit.slot < 0 ? 0 : 2*_edit.slot + 1 + _edit.second;
+
+    if (_edit.slot < 0)
+        champion = put;
+    else if (_edit.second)
+        slots.write(_edit.slot).set_pair_second(put);
     else
-        _parent->set_pair_second(_winner);
-}
\ No newline at end of file
+        slots.write(_edit.slot).set_pair_first(put);
+    if (!rewrite)
+    {
+        // Only the net change to each spot is kept, so a write that puts back
+        // the team the spot has on file (like an undo) leaves nothing to save
+        auto found = unsaved.emplace(spot_key(_edit.slot, _edit.second),
+            make_pair(taken, put)).first;
+        found->second.second = put;
+        if (found->second.first == put)
+            unsaved.erase(found);
+    }
+
+    if (_edit.slot < 0)
+        return;
+    if (taken != NO_TEAM)
+        seed_slots.write(taken) = child;
+    if (put != NO_TEAM)
+        seed_slots.write(put) = _edit.slot;
+}
+
+
+/**
+ * @brief takes back the last advance. Advances are undone newest first, so
+ *        any later game the team was advanced into has already been undone.
+ * 
+ * @return true if an advance was taken back
+ * @return false if there was nothing to undo
+ */
+bool bracket::undo()
+{
+    if (!journal.can_undo())
+        return false;
+    write_spot(journal.undo(), false);
+    return true;
+}
+
+
+/**
+ * @brief makes the last advance that was taken back again
+ * 
+ * @return true if an advance was made again
+ * @return false if there was nothing to redo
+ */
+bool bracket::redo()
+{
+    if (!journal.can_redo())
+        return false;
+    write_spot(journal.redo(), true);
+    return true;
+}
+
+
+/**
+ * @brief Returns the number of advances in effect. Passing it to rollback()
+ *        later takes back everything advanced in between, without having to
+ *        keep a copy of the bracket.
+ * 
+ * @return size_t: the position in the edit journal
+ */
+size_t bracket::edit_position() const
+{
+    return journal.position();
+}
+
+
+/**
+ * @brief takes back every advance made after a point, newest first. The
+ *        advances can still be redone one at a time until the next advance.
+ * 
+ * @param _position is a point from edit_position()
+ * @throws invalid_argument if the point is later than the current one
+ */
+void bracket::rollback(size_t _position)
+{
+    if (_position > journal.position())
+        throw invalid_argument("Can't roll back to a later edit.");
+    while (journal.position() > _position)
+        write_spot(journal.undo(), false);
+}
@@ -2,7 +2,7 @@
  * @file bracket.h
  * @author Henry Kaus (https://github.com/henrykaus)
  * @brief Holds definition for the bracket -- a full and complete binary search
- *        tree.
+ *        tree stored implicitly in one heap-ordered array.
  * 
  * @copyright Copyright (c) 2022
  */
@@ -14,21 +14,56 @@
 #include <stdexcept>
 #include <cmath>
 #include <fstream>
-#include <stack>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <future>
+#include <mutex>
 #include "node.h"
+#include "cow_array.h"
+#include "mapped_file.h"
+#include "saved_format.h"
+#include "bracket_parser.h"
+#include "bracket_picks.h"
+#include "edit_journal.h"
+#include "seed_order.h"
 #include "team.h"
 #include "utils.h"
 
 static const int SIZE_PAIR_PADDING = 18;    // Size of matchup pair in print
+static const int MAX_TEAMS = 1 << 24;       // Most teams in one bracket
+static const int LOG_MIN_EDITS = 256;       // Fewest logged edits to compact
+
+// Held while a save or its edit log is written or read (see bracket.cpp)
+std::mutex & saved_file_lock();
+
+// Slots are int indices and children are found at 2i+2, team ids are stored
+// in 32 bits with the highest reserved for NO_TEAM
+static_assert(MAX_TEAMS <= INT_MAX / 4, "Slot arithmetic would overflow an int");
+static_assert((std::uint64_t)MAX_TEAMS < NO_TEAM, "Team ids would overflow a team_id");
 
 /**
  * @brief A binary search tree for a 2^n number of seeded teams. Has methods to
- *        initialize an empty bracket and a bracket that has been modified, to 
+ *        initialize an empty bracket and a bracket that has been modified, to
  *        save the bracket, print the bracket, and have the user modify the
  *        bracket by advancing winners through. A bracket that has been saved
  *        must be initialized through fill_bracket(), NOT init_bracket(). init
  *        is solely for a list of teams with seeds, not matchups (see file in
  *        resources/new and resources/saved).
+ *
+ *        The tree is always complete and balanced, so every node lives in one
+ *        contiguous array in heap order: the final is slot 0, the children of
+ *        slot i are 2i+1 and 2i+2, and the first round occupies the last
+ *        (bracket_spots+1)/2 slots. Each team is stored once in the team
+ *        table (a team's id is its seed - 1), nodes only hold team ids, and
+ *        the winner of the final is kept apart as the champion.
+ *
+ *        See bracket_picks.h for the picks as one bit per game,
+ *        edit_journal.h for undo and redo, cow_array.h for cheap copies, and
+ *        saved_format.h for saves and their edit logs.
  */
 class bracket : protected utils
 {
@@ -44,40 +79,116 @@ class bracket : protected utils
         void init_bracket(const std::string & _file_name);
         // Initialize bracket with a previously modified bracket file
         void fill_bracket(const std::string & _file_name);
+        // Initialize bracket with the bytes of a save held in memory
+        void fill_bracket(const char * _bytes, std::size_t _size);
         // Save bracket to the file system
         void save_bracket(const std::string & _file_name) const;
+        // Save only the changes since the bracket was loaded from or saved to
+        // the file, or the whole bracket if it came from somewhere else
+        void save_changes(const std::string & _file_name);
+        // Checks if there is anything for save_changes() to write
+        bool has_unsaved_changes() const;
+        // Mark the bracket as saved by something other than save_changes()
+        void mark_saved();
+        // Lay out the bracket in the binary save format (see saved_format.h)
+        void write_binary(std::string & _buffer) const;
+        // Save bracket to the file system in the older preorder text format
+        void save_bracket_text(const std::string & _file_name) const;
         // Print bracket to screen
         void draw() const;
+        // Print bracket to a stream, or lay it out in a string
+        void draw(std::ostream & _out) const;
+        void draw(std::string & _out) const;
         // Have user pick a team to advance
         void user_advance_winner();
+        // Advance a team by its seed
+        bool advance_team(int _seed);
+        // Get a team from the team table (NO_TEAM gives an empty team)
+        const team & get_team(team_id _id) const;
+        // Get a slot of the heap-ordered tree (0 is the final)
+        const node & get_slot(int _slot) const;
+        // Slot a team has advanced furthest to (-1 if not in bracket)
+        int  team_slot(team_id _id) const;
+        int  num_teams() const;                 // Number of teams in bracket
+        int  num_rounds() const;                // Number of rounds of games
+        // Round a slot is played in (0 is the first round)
+        int  slot_round(int _slot) const;
+        // First slot of a round, its games are this slot and the next
+        // num_teams() >> (_round + 1) - 1 slots
+        int  round_first_slot(int _round) const;
+        // Label of a round as in the header of draw() (0 is the first round)
+        std::string round_name(int _round) const;
+        // Winner of the final (NO_TEAM if it hasn't been decided)
+        team_id get_champion() const;
+        // Winner of every game packed one bit per game
+        bracket_picks get_picks() const;
+        // Replace every game after the first round with the winners in picks
+        void set_picks(const bracket_picks & _picks);
+        // Take back the last advance (false if there is none)
+        bool undo();
+        // Make the last advance taken back again (false if there is none)
+        bool redo();
+        // Number of advances in effect, a point that can be rolled back to
+        std::size_t edit_position() const;
+        // Take back every advance made after a point from edit_position()
+        void rollback(std::size_t _position);
     
     protected:
-        node * root;            // Root of bracket tree
-        int    bracket_spots;   // How many elements in tree
-        int    bracket_gap;     // Padding between outermost bracket spots
+        cow_array<node> slots;          // Heap-ordered nodes, slots[0] is the final
+        int             bracket_spots;  // How many elements in tree
+        // Team table, indexed by team_id, shared by copies and never written
+        // once loaded
+        std::shared_ptr<std::vector<team>> teams;
+        // Seed index, slot each team_id has advanced furthest to (-1 for none)
+        cow_array<int>  seed_slots;
+        team_id         champion;       // Winner of the final
+        edit_journal    journal;        // Advances that can be undone or redone
+
+        // Waits for the edit log to be folded into the save
+        void finish_compaction();
 
     private:
+        std::string     saved_file;     // File last loaded from or saved to
+        std::uint64_t   saved_checksum; // Checksum of that file's save
+        // Spots changed since then, by spot (see spot_key()), each with the
+        // team it has in that file and the team it has now
+        std::unordered_map<std::uint64_t, std::pair<team_id, team_id>> unsaved;
+        std::size_t     log_edits;      // Edits in that file's edit log
+        bool            rewrite;        // If the next save must be whole
+        std::shared_ptr<const bracket> compacting;  // Copy being folded in
+        // Folds the log into the save, gives if it did and the new checksum
+        std::future<std::pair<bool, std::uint64_t>> compaction;
+
+
         // Various helper functions for the public methods
         void copy_bracket(const bracket &);
-        void copy_bracket(node *&, node *);
         void init(int);
         void create_tree();
-        void create_tree(node *, int, int);
-        team ** order_comp_bracket(team **, int);
-        void fill_bracket(team **, int);
-        void fill_bracket(node *, team **, int &);
-        void draw(node * _left_root, node * _right_root, int _curr_depth,
-            int & _max_depth) const;
-        void draw_pairs(const std::pair<team, team> &,
-            const std::pair<team, team> &, int _left_padding = 0) const;
-        void draw_pair(const std::pair<team, team> &, int) const;
+        void fill_bracket(const parsed_team **, int);
         void erase();
-        void erase(node *);
         bool search_and_decide(int);
-        bool search_and_decide(node *, node *, char, int);
-        void advance_winner(const team &, node *, char);
-        void save_bracket(std::ofstream &, node *) const;
-        void fill_bracket(std::ifstream & inFile, node *& _root);
+        void build_seed_index();
+        void advance_winner(team_id, int, char);
+        void write_spot(const slot_edit &, bool);
+        void save_bracket(std::ofstream &, int) const;
+        void fill_bracket(bracket_parser & _parser);
+        void fill_bracket(bracket_parser & _parser, int _root);
+        team_id intern_team(const parsed_team &);
+        void reset_teams(int _num_teams);
+        void load_binary(const char * _bytes, std::size_t _size);
+        bool seeded_game(const seed_order &, int, team_id, team_id) const;
+        bool won_game(int, team_id) const;
+        bool write_save(const std::string &, std::uint64_t &, bool _replace_only = false) const;
+        void replay_log(const std::string & _log_file);
+        bool append_log(const std::string & _log_file) const;
+        // Key of a spot (-1 is the champion's), ordered like the spots
+        static std::uint64_t spot_key(int _slot, bool _second);
+
+        // Index arithmetic for the implicit tree
+        int  left_child(int _slot) const;
+        int  right_child(int _slot) const;
+        int  parent(int _slot) const;
+        bool is_leaf(int _slot) const;
 };
 
 #endif
\ No newline at end of file
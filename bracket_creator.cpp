@@ -176,7 +176,7 @@ bool bracket_creator::save() const
     // Get file name from user for new file
     read_output_file(output_file);
     // If exists, ask for confirmation
-    while (check_file_exists(output_file, "resources\\new"))
+    while (check_file_exists(output_file, "resources/new"))
     {
         cout << endl;
         if (are_you_sure(cin, "This file name already exists, would you still like to save to this file"))
@@ -189,7 +189,7 @@ bool bracket_creator::save() const
     }
 
     cout << "Saving progress..." << endl << endl;
-    this->save("resources\\new\\" + output_file);
+    this->save("resources/new/" + output_file);
     return true;
 }
 
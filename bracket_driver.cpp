@@ -9,8 +9,21 @@
 #include "bracket_driver.h"
 using namespace std;
 
-// Default constructor
-bracket_driver::bracket_driver() : input_file("NONE")
+// Default constructor, saved brackets are kept in resources/saved
+bracket_driver::bracket_driver() : input_file("NONE"),
+    new_files("resources/new", "resources/new.catalog"),
+    saved(new directory_store("resources/saved", "resources/saved.catalog"))
+{}
+
+
+/**
+ * @brief Param. constructor that keeps saved brackets in a store other than
+ *        resources/saved, such as an archive file
+ * 
+ * @param _saved is the store to keep saved brackets in
+ */
+bracket_driver::bracket_driver(unique_ptr<bracket_store> _saved) : input_file("NONE"),
+    new_files("resources/new", "resources/new.catalog"), saved(move(_saved))
 {}
 
 
@@ -23,6 +36,7 @@ void bracket_driver::start()
 {
     vector<string> file_options;    // File names in directory
     int            menu_option;     // Menu choice
+    bool           file_exists;     // If saved files were found
     
     cout << endl;
     do {
@@ -33,31 +47,28 @@ void bracket_driver::start()
             case 0:         // Quit program
                 break;
             case 1:         // Edit new file
-                get_files(file_options, "resources\\new");
+                new_files.get_files(file_options);
                 modify_bracket(file_options, false);
                 break;
             case 2:         // View existing file
-                bool file_exists;
-                try {
-                    get_files(file_options, "resources\\saved");
-                    file_exists = true;
-                }
-                // No files exist in resources/saved
-                catch (const invalid_argument & err) {
-                    get_files(file_options, "resources\\new");
-                    file_exists = false;
-                    cout << "No existing files. Please select a new file."
-                        << endl;
-                }
+                file_exists = get_existing_files(file_options);
                 modify_bracket(file_options, file_exists);
                 break;
             case 3:         // Delete existing file
-                get_files(file_options, "resources\\saved");
+                saved->get_files(file_options);
                 delete_bracket(file_options);
                 break;
             case 4:         // Create a new starter bracket
                 create_a_bracket();
                 break;
+            case 5:         // Simulate odds for a bracket
+                file_exists = get_existing_files(file_options);
+                simulate_bracket(file_options, file_exists);
+                break;
+            case 6:         // Score saved brackets against results
+                file_exists = get_existing_files(file_options);
+                score_pool(file_options, file_exists);
+                break;
             default:
                 break;
         }
@@ -69,7 +80,8 @@ void bracket_driver::start()
  * @brief Prints main menu and takes input from user via stdin
  * 
  * @return int: option to run (1: new bracket, 2: existing bracket, 3: delete
- *              bracket, 4: new starter bracket, 0: quit program)
+ *              bracket, 4: new starter bracket, 5: simulate odds, 6: score
+ *              pool, 0: quit program)
  */
 int bracket_driver::read_main_menu_option()
 {
@@ -80,16 +92,140 @@ int bracket_driver::read_main_menu_option()
          << "  [2] Select an Existing Bracket" << endl
          << "  [3] Delete an Existing Bracket" << endl
          << "  [4] Create a New Starter Bracket" << endl
+         << "  [5] Simulate a Bracket's Odds" << endl
+         << "  [6] Score a Pool of Brackets" << endl
          << "  [0] Quit the Program" << endl
          << "-> ";
 
-    option = integer_input(cin, "-> ", 0, 4);
+    option = integer_input(cin, "-> ", 0, 6);
     cout << endl;
 
     return option;
 }
 
 
+/**
+ * @brief Fills a list with saved brackets, or with new brackets if there are no
+ *        saved brackets yet.
+ * 
+ * @param _file_options is a std::vector<std::string> to fill (must be empty)
+ * @return true if the list holds saved brackets (resources/saved)
+ * @return false if the list holds new brackets (resources/new)
+ */
+bool bracket_driver::get_existing_files(vector<string> & _file_options)
+{
+    try {
+        saved->get_files(_file_options);
+        return true;
+    }
+    // No files exist in resources/saved
+    catch (const invalid_argument & err) {
+        new_files.get_files(_file_options);
+        cout << "No existing files. Please select a new file." << endl;
+        return false;
+    }
+}
+
+
+/**
+ * @brief Lets user pick a bracket, plays it out many times (or works out the
+ *        odds exactly), and prints each team's odds of reaching each round.
+ * 
+ * @param _file_options is a std::vector<std::string> of possible brackets to 
+ *                      simulate
+ * @param _editing_existing is if the options are saved brackets
+ */
+void bracket_driver::simulate_bracket(const vector<string> & _file_options,
+    bool _editing_existing)
+{
+    int trials;     // Number of tournaments to play
+
+    if (read_bracket_choice(_file_options))
+    {
+        try {
+            fill_bracket(_editing_existing);
+            cout << "How many tournaments would you like to simulate (0 for "
+                 << "exact odds)? ";
+            trials = integer_input(cin, "Please enter a valid number: ", 0);
+            cout << endl;
+
+            simulator odds(*this);
+            if (trials == 0)
+                odds.exact();
+            else
+                odds.monte_carlo(trials);
+            odds.display();
+            cout << endl;
+        }
+        catch (const invalid_argument & err) {
+            cerr << err.what() << endl << endl;
+        }
+    }
+}
+
+
+/**
+ * @brief Lets user pick the bracket with the actual results, then scores every
+ *        other saved bracket with the same teams against it as a pool entry
+ *        and prints the leaderboard.
+ * 
+ * @param _file_options is a std::vector<std::string> of possible brackets to 
+ *                      score against
+ * @param _editing_existing is if the options are saved brackets
+ */
+void bracket_driver::score_pool(const vector<string> & _file_options,
+    bool _editing_existing)
+{
+    int skipped = 0;    // Saved brackets not in the pool
+
+    if (!_editing_existing)
+    {
+        cout << "A pool needs saved brackets to score." << endl << endl;
+        return;
+    }
+
+    cout << "Which bracket holds the actual results?" << endl;
+    if (read_bracket_choice(_file_options))
+    {
+        try {
+            fill_bracket(_editing_existing);
+            pool entries(*this);
+
+            for (int i = 0; i < (int)_file_options.size(); ++i)
+            {
+                if (_file_options[i] == input_file)
+                    continue;
+                // Store knows the size, so other brackets aren't opened
+                if (saved->num_teams(_file_options[i]) != num_teams())
+                {
+                    ++skipped;
+                    continue;
+                }
+                try {
+                    bracket entry;
+                    saved->load(_file_options[i], entry);
+                    entries.add_entry(_file_options[i], entry);
+                }
+                // Entry is unreadable or for a different bracket
+                catch (const invalid_argument & err) {
+                    ++skipped;
+                }
+            }
+
+            entries.score();
+            entries.display(10);
+            if (skipped > 0)
+                cout << skipped << " saved bracket(s) were for a different "
+                     << "bracket and weren't scored." << endl;
+            cout << endl;
+        }
+        catch (const invalid_argument & err) {
+            cerr << err.what() << endl << endl;
+        }
+    }
+}
+
+
 /**
  * @brief Lets user pick a bracket to view, fills bracket, allows for
  *        modification, and saves the bracket.
@@ -155,39 +291,221 @@ bool bracket_driver::read_bracket_choice(const vector<string> & _file_options)
 void bracket_driver::fill_bracket(bool _editing_existing)
 {
     if (_editing_existing)
-        bracket::fill_bracket("resources\\saved\\" + input_file);
+        saved->load(input_file, *this);
     else
-        bracket::init_bracket("resources\\new\\" + input_file);
+        bracket::init_bracket("resources/new/" + input_file);
 }
 
 
 /**
- * @brief Has user view and edit bracket until they decide to quit
+ * @brief Has user view and edit bracket until they decide to quit. On a
+ *        terminal, only the spots that changed are repainted after each edit
+ *        (see terminal_view). Brackets over MAX_DRAWN_TEAMS teams are too wide
+ *        to draw whole, so they're looked at a region or a team at a time.
  */
 void bracket_driver::view_edit_bracket()
 {
-    char option;
+    terminal_view view(*this);  // Screen the bracket is shown on
+    bool          whole;        // If the whole bracket is on the screen
+    int           option;       // Menu choice
 
     // Initial bracket view
-    bracket::draw();
+    whole = num_teams() <= MAX_DRAWN_TEAMS;
+    if (whole)
+        view.draw();
+    else
+        cout << "This bracket is too large to draw whole, view a region or a "
+             << "team's path instead." << endl;
     cout << endl;
-    option = y_n_input(cin, "Would you like to continue editing");
 
     // Draw/edit bracket
-    while (option == 'Y')
+    while ((option = read_edit_menu_option(view, whole)) != 0)
     {
-        bracket::user_advance_winner();
-        cout << endl;
-        bracket::draw();
-        cout << endl;
-        option = y_n_input(cin, "Would you like to continue editing");
+        switch (option)
+        {
+            case 1:         // Advance a team
+                bracket::user_advance_winner();
+                cout << endl;
+                show_changes(view, whole);
+                break;
+            case 2:         // View whole bracket
+                if (num_teams() > MAX_DRAWN_TEAMS)
+                {
+                    cout << "This bracket is too large to draw whole." << endl << endl;
+                    break;
+                }
+                view.draw();
+                whole = true;
+                cout << endl;
+                break;
+            case 3:         // View a region
+                view_region();
+                whole = false;
+                break;
+            case 4:         // View a team's path
+                view_path();
+                whole = false;
+                break;
+            case 5:         // Undo the last advance
+                if (bracket::undo())
+                    cout << "Took back the last advance." << endl << endl;
+                else
+                    cout << "There is nothing to undo." << endl << endl;
+                show_changes(view, whole);
+                break;
+            case 6:         // Redo the last advance taken back
+                if (bracket::redo())
+                    cout << "Made the advance again." << endl << endl;
+                else
+                    cout << "There is nothing to redo." << endl << endl;
+                show_changes(view, whole);
+                break;
+            case 7:         // Undo several advances
+                roll_back();
+                show_changes(view, whole);
+                break;
+            default:
+                break;
+        }
     }
 }
 
 
+/**
+ * @brief Prints the editing menu under the bracket and takes input from user
+ *        via stdin
+ * 
+ * @param _view is the screen the bracket is shown on
+ * @param _whole is if the whole bracket is on the screen
+ * @return int: option to run (1: advance team, 2: view whole bracket, 3: view
+ *              region, 4: view team's path, 5: undo, 6: redo, 7: undo
+ *              several, 0: done editing)
+ */
+int bracket_driver::read_edit_menu_option(terminal_view & _view, bool _whole)
+{
+    int option;
+
+    // Keep menu from scrolling the bracket off the screen
+    if (_whole)
+        _view.clear_prompt();
+
+    cout << "What would you like to do?" << endl
+         << "  [1] Advance a Team" << endl
+         << "  [2] View the Whole Bracket" << endl
+         << "  [3] View a Region" << endl
+         << "  [4] View a Team's Path" << endl
+         << "  [5] Undo the Last Advance" << endl
+         << "  [6] Redo an Advance" << endl
+         << "  [7] Undo Several Advances" << endl
+         << "  [0] Done Editing" << endl
+         << "-> ";
+
+    option = integer_input(cin, "-> ", 0, 7);
+    cout << endl;
+
+    return option;
+}
+
+
+/**
+ * @brief Shows the bracket after it was edited, if it is small enough to draw
+ *        whole. Only the spots that changed are repainted if the whole bracket
+ *        is already on the screen.
+ * 
+ * @param _view is the screen the bracket is shown on
+ * @param _whole is if the whole bracket is on the screen, set to true if it
+ *        was drawn
+ */
+void bracket_driver::show_changes(terminal_view & _view, bool & _whole)
+{
+    if (num_teams() > MAX_DRAWN_TEAMS)
+        return;
+    if (_whole)
+        _view.redraw();
+    else
+        _view.draw();
+    _whole = true;
+    cout << endl;
+}
+
+
+/**
+ * @brief Asks how many advances to take back and rolls the bracket back to
+ *        before them, newest first. They can be redone one at a time.
+ */
+void bracket_driver::roll_back()
+{
+    int applied = edit_position();  // Advances that can be taken back
+    int steps;                      // Advances to take back
+
+    cout << "How many advances would you like to take back (0-" << applied << ")? ";
+    steps = integer_input(cin, "Please enter a valid number: ", 0, applied);
+    rollback(applied - steps);
+    cout << "Took back " << steps << " advance(s)." << endl << endl;
+}
+
+
+/**
+ * @brief Asks which game to view the region under and how many rounds back
+ *        to show, then draws only that part of the bracket.
+ */
+void bracket_driver::view_region()
+{
+    bracket_renderer renderer(*this);   // Lays out the region
+    string           buffer;            // Region drawn
+    int              round;             // Round of the game at the top
+    int              games;             // Games in that round
+    int              game;              // Game at the top, from the top
+    int              back;              // Rounds to show
+
+    cout << "Which round should the region end at (1-" << num_rounds() << ")? ";
+    round = integer_input(cin, "Please enter a valid round: ", 1, num_rounds()) - 1;
+    games = num_teams() >> (round + 1);
+    cout << "Which game of " << round_name(round) << " (1-" << games << ")? ";
+    game  = integer_input(cin, "Please enter a valid game: ", 1, games) - 1;
+    cout << "How many rounds should it show (1-" << round + 1 << ")? ";
+    back  = integer_input(cin, "Please enter a valid number: ", 1, round + 1);
+    cout << endl;
+
+    // Games of a round are the slots from its first slot, top to bottom
+    renderer.render_region(round_first_slot(round) + game,
+        round - back + 1, round, buffer);
+    cout.write(buffer.data(), buffer.size());
+    cout << endl;
+}
+
+
+/**
+ * @brief Asks for a team and draws each game on its path to the final.
+ */
+void bracket_driver::view_path()
+{
+    bracket_renderer renderer(*this);   // Lays out the path
+    string           buffer;            // Path drawn
+    int              seed;              // Seed of the team to follow
+
+    cout << "Which team would you like to follow (team seed)? ";
+    seed = integer_input(cin, "Please enter a valid seed: ", 1, num_teams());
+    cout << endl;
+
+    try {
+        renderer.render_path(seed - 1, buffer);
+        cout.write(buffer.data(), buffer.size());
+    }
+    catch (const invalid_argument & err) {
+        cout << err.what() << endl;
+    }
+    cout << endl;
+}
+
+
 /**
  * @brief Saves a file to filesystem by asking user to save changes and for a 
- *        file name if appropriate.
+ *        file name if appropriate. An existing file that wasn't changed isn't
+ *        saved, and one that was only has its changes written. Saves are in
+ *        the binary format and named with SAVED_EXTENSION, so a bracket opened
+ *        from an older text save is saved next to it under that extension,
+ *        leaving the text save as it was.
  * 
  * @param _editing_existing is if the user is editing an existing file
  */
@@ -196,6 +514,12 @@ void bracket_driver::save(bool _editing_existing)
     string output_file; // File to save to
     char   option;
 
+    if (!has_unsaved_changes())
+    {
+        cout << "No changes to save." << endl << endl;
+        return;
+    }
+
     // Check if want to save
     option = y_n_input(cin, "Would you like to save your changes");
     if (option == 'N') {
@@ -204,12 +528,22 @@ void bracket_driver::save(bool _editing_existing)
     }
 
     // Assign file name to output file
-    if (!_editing_existing)
+    if (_editing_existing && filesystem::path(input_file).extension() == SAVED_EXTENSION)
+        output_file = input_file;
+    else
     {
-        // Get file name from user for new file
-        read_output_file(output_file);
+        if (_editing_existing)
+        {
+            // Text save, kept as it is
+            output_file = filesystem::path(input_file).replace_extension(SAVED_EXTENSION).string();
+            cout << input_file << " is an older text save, so this bracket is saved as "
+                 << output_file << "." << endl;
+        }
+        else
+            // Get file name from user for new file
+            read_output_file(output_file, SAVED_EXTENSION);
         // If exists, ask for confirmation
-        while (check_file_exists(output_file, "resources\\saved"))
+        while (saved->contains(output_file))
         {
             cout << endl;
             if (are_you_sure(cin, "This file name already exists, would you still like to save to this file"))
@@ -217,15 +551,14 @@ void bracket_driver::save(bool _editing_existing)
             else
             {
                 cout << endl;
-                read_output_file(output_file);
+                read_output_file(output_file, SAVED_EXTENSION);
             }
         }
     }
-    else
-        output_file = input_file;
 
     cout << "Saving progress..." << endl << endl;
-    bracket::save_bracket("resources\\saved\\" + output_file);
+    saved->save(output_file, *this);
+    saved->commit();
 }
 
 
@@ -238,7 +571,6 @@ void bracket_driver::save(bool _editing_existing)
 void bracket_driver::delete_bracket(const vector<string> & _file_options)
 {
     int    option;                                      // Menu choice
-    string file_to_delete = ".\\resources\\saved\\";    // File to delete
     string are_you_sure_msg = "Are you sure you want to delete ";
 
     // Print list of existing files
@@ -257,13 +589,14 @@ void bracket_driver::delete_bracket(const vector<string> & _file_options)
     are_you_sure_msg += _file_options[option - 1];
     if (!are_you_sure(cin, are_you_sure_msg.c_str(), true)) return;
 
-    // Delete file/throw error
-    file_to_delete += _file_options[option - 1].c_str();
-    if (remove(file_to_delete.c_str()) != 0)
+    // Delete file/throw error, after any save of it is done
+    finish_compaction();
+    if (!saved->remove(_file_options[option - 1]))
     {
         cerr << "ERROR: file does not exist." << endl << endl;
         return;
     }
+    saved->commit();
 
     cout << _file_options[option - 1].c_str() << " was removed." << endl << endl;
 }
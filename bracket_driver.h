@@ -14,8 +14,17 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <memory>
 #include "bracket.h"
 #include "bracket_creator.h"
+#include "simulator.h"
+#include "pool.h"
+#include "terminal_view.h"
+#include "catalog.h"
+#include "bracket_store.h"
+#include "directory_store.h"
+
+static const int MAX_DRAWN_TEAMS = 64;  // Most teams to draw whole on screen
 
 /**
  * @brief Holds methods for the user interface to interact with brackets by
@@ -26,10 +35,12 @@ class bracket_driver : public bracket
 {
     public:
         bracket_driver();   // Default constructor
+        // Param. constructor, saved brackets are kept in _saved
+        bracket_driver(std::unique_ptr<bracket_store> _saved);
 
         // Ask for new (resources/new) or existing file (resources/saved),
         // displays current options, saves to an array, fills bracket based on 
-        // input, & saves to appropriate file (" "_saved.txt in resources/saved)
+        // input, & saves to appropriate file (" ".pbrk in resources/saved)
         void start();
         
     private:
@@ -39,8 +50,18 @@ class bracket_driver : public bracket
         bool read_bracket_choice(const std::vector<std::string> & files_options);
         void fill_bracket(bool _editing_existing);
         void view_edit_bracket();
+        int  read_edit_menu_option(terminal_view & _view, bool _whole);
+        void show_changes(terminal_view & _view, bool & _whole);
+        void roll_back();
+        void view_region();
+        void view_path();
         void save(bool _editing_existing);
         void delete_bracket(const std::vector<std::string> & _file_options);
+        bool get_existing_files(std::vector<std::string> & _file_options);
+        void simulate_bracket(const std::vector<std::string> & _file_options,
+            bool _editing_existing);
+        void score_pool(const std::vector<std::string> & _file_options,
+            bool _editing_existing);
 
         void create_a_bracket();
         int  read_creator_menu_option();
@@ -49,8 +70,10 @@ class bracket_driver : public bracket
 
     protected:
         std::string input_file; // File that the bracket was read from 
-                                // (file_name.txt)
+                                // (file_name.txt or file_name.pbrk)
         bracket_creator creator;
+        catalog         new_files;      // Index of resources/new
+        std::unique_ptr<bracket_store> saved;   // Where saved brackets are kept
 };
 
 #endif
\ No newline at end of file
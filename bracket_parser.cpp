@@ -0,0 +1,228 @@
+/**
+ * @file bracket_parser.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the bracket_parser class which parses
+ *        division and saved bracket text from a buffer.
+ * 
+ * @copyright Copyright (c) 2022
+ */
+#include "bracket_parser.h"
+#include <cstring>
+#include <charconv>
+using namespace std;
+
+/**
+ * @brief Param. constructor for a parse error.
+ * 
+ * @param _line is the line of the error (from 1)
+ * @param _column is the column of the error (from 1)
+ * @param _msg is what was expected
+ */
+parse_error::parse_error(int _line, int _column, const string & _msg)
+    : invalid_argument("File formatted incorrectly at line " + to_string(_line)
+        + ", column " + to_string(_column) + ": " + _msg),
+      line(_line), column(_column)
+{}
+
+
+// Getters
+int parse_error::get_line() const   { return line; }
+int parse_error::get_column() const { return column; }
+
+
+/**
+ * @brief Param. constructor that starts at the first line of a buffer.
+ * 
+ * @param _bytes is the start of the buffer (may be null if _size is 0)
+ * @param _size is the number of bytes in the buffer
+ */
+bracket_parser::bracket_parser(const char * _bytes, size_t _size)
+    : end(_bytes + _size), pos(_bytes), line_start(_bytes),
+      line_end(_bytes), line(1)
+{}
+
+
+/**
+ * @brief Checks if every line has been read. A newline at the very end of the
+ *        buffer does not start another line.
+ * 
+ * @return true if there is nothing left to parse
+ */
+bool bracket_parser::at_end() const
+{
+    return pos >= end;
+}
+
+
+/**
+ * @brief Returns the line number of the next line to be read.
+ * 
+ * @return int: the line number (from 1)
+ */
+int bracket_parser::get_line() const
+{
+    return line;
+}
+
+
+/**
+ * @brief Reads one team line of a division file (resources/new).
+ * FORMAT: SCHOOL_NAME;WINS;LOSSES;TIES;SEED
+ * 
+ * @param _team is filled with the team
+ * @throws parse_error if the line is formatted incorrectly
+ */
+void bracket_parser::read_team(parsed_team & _team)
+{
+    start_line();
+    read_team_fields(_team, true);
+    finish_line();
+}
+
+
+/**
+ * @brief Reads one node line of a saved bracket (resources/saved).
+ * FORMAT: FIRST_TEAM;SECOND_TEAM;HAS_CHILDREN
+ * 
+ * @param _first is filled with the first team of the matchup
+ * @param _second is filled with the second team of the matchup
+ * @return true if the node has children
+ * @throws parse_error if the line is formatted incorrectly
+ */
+bool bracket_parser::read_saved_node(parsed_team & _first, parsed_team & _second)
+{
+    int has_children;
+
+    start_line();
+    read_team_fields(_first, false);
+    read_team_fields(_second, false);
+    has_children = read_number(true, "0 or 1 for whether the node has children");
+    if (has_children != 0 && has_children != 1)
+        fail("0 or 1 for whether the node has children");
+    finish_line();
+    return has_children;
+}
+
+
+/**
+ * @brief private helper that finds the end of the next line.
+ * 
+ * @throws parse_error if there are no lines left or the line is empty
+ */
+void bracket_parser::start_line()
+{
+    line_start = pos;
+    if (pos >= end)
+        fail("another line (file ended early)");
+
+    line_end   = (const char *)memchr(pos, '\n', end - pos);
+    if (!line_end)
+        line_end = end;
+    if (line_end > line_start && line_end[-1] == '\r')
+        --line_end;
+    if (line_end == line_start)
+        fail("a line with data (ensure no empty lines)");
+}
+
+
+/**
+ * @brief private helper that moves past the newline of the current line.
+ */
+void bracket_parser::finish_line()
+{
+    const char * newline = (const char *)memchr(line_end, '\n', end - line_end);
+
+    pos = newline ? newline + 1 : end;
+    ++line;
+}
+
+
+/**
+ * @brief private helper that reads the five fields of a team.
+ * 
+ * @param _team is filled with the team
+ * @param _last is if the team's seed is the last field of the line
+ */
+void bracket_parser::read_team_fields(parsed_team & _team, bool _last)
+{
+    _team.school_name = read_field(false, "a school name");
+    _team.wins        = read_number(false, "a number for wins");
+    _team.losses      = read_number(false, "a number for losses");
+    _team.ties        = read_number(false, "a number for ties");
+    _team.seed        = read_number(_last, "a number for seed");
+}
+
+
+/**
+ * @brief private helper that reads up to the next ';' (or the end of the line
+ *        for the last field).
+ * 
+ * @param _last is if the field is the last of the line
+ * @param _what is what the field should be, for errors
+ * @return string_view: the text of the field
+ */
+string_view bracket_parser::read_field(bool _last, const char * _what)
+{
+    const char * field_end = (const char *)memchr(pos, ';', line_end - pos);
+    string_view  field;
+
+    if (_last)
+    {
+        if (field_end)
+            fail("the end of the line");
+        field_end = line_end;
+    }
+    else if (!field_end)
+        fail(_what);
+
+    field = string_view(pos, field_end - pos);
+    pos   = field_end + !_last;
+    return field;
+}
+
+
+/**
+ * @brief private helper that reads a whole number field. Spaces before the
+ *        number are skipped.
+ * 
+ * @param _last is if the field is the last of the line
+ * @param _what is what the field should be, for errors
+ * @return int: the number
+ */
+int bracket_parser::read_number(bool _last, const char * _what)
+{
+    int          number;
+    const char * field_end = _last ? line_end :
+        (const char *)memchr(pos, ';', line_end - pos);
+
+    if (!field_end)
+        field_end = line_end;
+    while (pos < field_end && (*pos == ' ' || *pos == '\t'))
+        ++pos;
+
+    from_chars_result result = from_chars(pos, field_end, number);
+    if (result.ec != errc() || result.ptr != field_end)
+        fail(_what);
+
+    pos = field_end;
+    if (!_last)
+    {
+        if (pos == line_end)
+            fail("';' after the number");
+        ++pos;
+    }
+    return number;
+}
+
+
+/**
+ * @brief private helper that throws a parse error at the current position.
+ * 
+ * @param _what is what was expected
+ * @throws parse_error always
+ */
+void bracket_parser::fail(const char * _what) const
+{
+    throw parse_error(line, (int)(pos - line_start) + 1,
+        string("expected ") + _what);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file bracket_parser.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the bracket_parser class which reads the text
+ *        formats of resources/new and resources/saved from a buffer.
+ * 
+ * @copyright Copyright (c) 2022
+ */
+#ifndef BRACKET_PARSER
+#define BRACKET_PARSER
+
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <cstddef>
+
+/**
+ * @brief A team as it appears in a text file. The name points into the buffer
+ *        being parsed, so it is only valid while the buffer is.
+ */
+struct parsed_team
+{
+    std::string_view school_name;   // Name of school
+    int              wins;          // Wins for season
+    int              losses;        // Losses for season
+    int              ties;          // Ties for season
+    int              seed;          // Seed in division
+};
+
+/**
+ * @brief Thrown for badly formatted text, with the line and column (both from
+ *        1) where parsing stopped.
+ */
+class parse_error : public std::invalid_argument
+{
+    public:
+        parse_error(int _line, int _column, const std::string & _msg);
+
+        int get_line() const;       // Line of the error
+        int get_column() const;     // Column of the error
+
+    private:
+        int line;
+        int column;
+};
+
+/**
+ * @brief Reads teams and saved bracket nodes one line at a time from a buffer
+ *        holding a whole file (see mapped_file). Lines are found with memchr
+ *        and numbers read with std::from_chars, so nothing is copied until a
+ *        caller keeps a name. Works on its own without a bracket.
+ * FORMAT (resources/new):   SCHOOL_NAME;WINS;LOSSES;TIES;SEED
+ * FORMAT (resources/saved): FIRST_TEAM;SECOND_TEAM;HAS_CHILDREN
+ */
+class bracket_parser
+{
+    public:
+        bracket_parser(const char * _bytes, std::size_t _size);
+
+        bool at_end() const;        // Checks if every line has been read
+        int  get_line() const;      // Line number of the next line (from 1)
+        // Reads a team line of a division file
+        void read_team(parsed_team & _team);
+        // Reads a node line of a saved bracket, returns if it has children
+        bool read_saved_node(parsed_team & _first, parsed_team & _second);
+
+    private:
+        const char * end;           // End of the buffer
+        const char * pos;           // Current place in the current line
+        const char * line_start;    // Start of the current line
+        const char * line_end;      // End of the current line (no newline)
+        int          line;          // Line number of the current line
+
+        void start_line();
+        void finish_line();
+        void read_team_fields(parsed_team & _team, bool _last);
+        std::string_view read_field(bool _last, const char * _what);
+        int  read_number(bool _last, const char * _what);
+        [[noreturn]] void fail(const char * _what) const;
+};
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * @file bracket_picks.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for bracket_picks, which packs the winner of
+ *        every game in a bracket into one bit.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "bracket_picks.h"
+using namespace std;
+
+// Default constructor
+bracket_picks::bracket_picks() : teams(0)
+{}
+
+
+/**
+ * @brief Param. constructor that makes picks for a bracket with no games
+ *        decided yet
+ *
+ * @param _num_teams is the number of teams in the bracket
+ *        (1) Must be a power of 2
+ * @throws invalid_argument if the number of teams is 1 or not a power of 2
+ */
+bracket_picks::bracket_picks(int _num_teams) : teams(_num_teams)
+{
+    if (_num_teams < 2 || !is_pow_two(_num_teams))
+        throw invalid_argument("Number of teams isn't power of two.");
+
+    winners.assign((_num_teams - 1 + 63) / 64, 0);
+    decided.assign(winners.size(), 0);
+}
+
+
+int bracket_picks::num_teams() const { return teams; }
+int bracket_picks::num_games() const { return teams ? teams - 1 : 0; }
+
+
+/**
+ * @brief private helper that checks a game is in the bracket
+ *
+ * @param _game is the slot of the game
+ * @throws out_of_range if there is no such game
+ */
+void bracket_picks::check_game(int _game) const
+{
+    if (_game < 0 || _game >= num_games())
+        throw out_of_range("No such game in bracket.");
+}
+
+
+/**
+ * @brief checks if a game has a winner picked
+ *
+ * @param _game is the slot of the game
+ * @return true if the game is decided
+ */
+bool bracket_picks::is_decided(int _game) const
+{
+    check_game(_game);
+    return (decided[_game / 64] >> (_game % 64)) & 1;
+}
+
+
+/**
+ * @brief checks which team won a game (only meaningful if it is decided)
+ *
+ * @param _game is the slot of the game
+ * @return true if the second team won, false if the first team won
+ */
+bool bracket_picks::second_won(int _game) const
+{
+    check_game(_game);
+    return (winners[_game / 64] >> (_game % 64)) & 1;
+}
+
+
+/**
+ * @brief picks the winner of a game
+ *
+ * @param _game is the slot of the game
+ * @param _second_won is false if the first team won, true if the second did
+ */
+void bracket_picks::set_winner(int _game, bool _second_won)
+{
+    uint64_t bit = 1ull << (_game % 64);    // Bit of the game in its word
+
+    check_game(_game);
+    decided[_game / 64] |= bit;
+    if (_second_won)
+        winners[_game / 64] |= bit;
+    else
+        winners[_game / 64] &= ~bit;
+}
+
+
+/**
+ * @brief marks a game as undecided. Its winner bit is cleared so that equal
+ *        picks always have equal bits.
+ *
+ * @param _game is the slot of the game
+ */
+void bracket_picks::clear_winner(int _game)
+{
+    uint64_t bit = 1ull << (_game % 64);    // Bit of the game in its word
+
+    check_game(_game);
+    decided[_game / 64] &= ~bit;
+    winners[_game / 64] &= ~bit;
+}
+
+
+/**
+ * @brief checks if every game of the bracket has a winner
+ *
+ * @return true if every game is decided
+ */
+bool bracket_picks::is_complete() const
+{
+    for (int i = 0; i < (int)decided.size(); ++i)
+    {
+        int      games = min(64, num_games() - 64*i);   // Games in this word
+        uint64_t full  = games == 64 ? ~0ull : (1ull << games) - 1;
+        if (decided[i] != full)
+            return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief counts the games that were decided in both picks but went to a
+ *        different team
+ *
+ * @param _other is the picks to compare to
+ * @return the number of games picked differently
+ * @throws invalid_argument if the picks are for a different size of bracket
+ */
+int bracket_picks::differences(const bracket_picks & _other) const
+{
+    int count = 0;  // Games picked differently
+
+    if (teams != _other.teams)
+        throw invalid_argument("Picks are for different sized brackets.");
+    for (int i = 0; i < (int)winners.size(); ++i)
+        count += popcount((winners[i] ^ _other.winners[i]) &
+            decided[i] & _other.decided[i]);
+    return count;
+}
+
+
+/**
+ * @brief hashes the picks, equal picks always hash the same
+ *
+ * @return a 64-bit hash of the number of teams and both bitsets
+ */
+uint64_t bracket_picks::hash() const
+{
+    vector<uint64_t> words;     // Everything that makes up the picks
+
+    words.reserve(1 + 2 * winners.size());
+    words.push_back(teams);
+    words.insert(words.end(), winners.begin(), winners.end());
+    words.insert(words.end(), decided.begin(), decided.end());
+    return checksum((const char *)words.data(), words.size() * sizeof(uint64_t));
+}
+
+
+/**
+ * @brief gives the winner bits of a complete bracket as one word
+ *
+ * @return the winner bits, bit i is set if the second team won game i
+ * @throws invalid_argument if the bracket is over 64 teams or isn't complete
+ */
+uint64_t bracket_picks::to_u64() const
+{
+    if (teams < 2 || teams > 64)
+        throw invalid_argument("Picks don't fit in one word.");
+    if (!is_complete())
+        throw invalid_argument("Not every game has a winner.");
+    return winners[0];
+}
+
+
+/**
+ * @brief sets the picks of a complete bracket from its winner bits
+ *
+ * @param _num_teams is the number of teams in the bracket, at most 64
+ * @param _winners is the winner bits, bit i is set if the second team won game i
+ * @throws invalid_argument if the number of teams isn't a power of 2 up to 64
+ *         or a bit is set past the last game
+ */
+void bracket_picks::from_u64(int _num_teams, uint64_t _winners)
+{
+    if (_num_teams > 64)
+        throw invalid_argument("Picks don't fit in one word.");
+    *this = bracket_picks(_num_teams);
+
+    uint64_t full = _num_teams == 64 ? ~0ull >> 1 : (1ull << (_num_teams - 1)) - 1;
+    if (_winners & ~full)
+        throw invalid_argument("Winner bit set for a game not in the bracket.");
+    winners[0] = _winners;
+    decided[0] = full;
+}
+
+
+const vector<uint64_t> & bracket_picks::get_winners() const { return winners; }
+const vector<uint64_t> & bracket_picks::get_decided() const { return decided; }
+
+
+// Equality operator
+bool bracket_picks::operator == (const bracket_picks & _other) const
+{
+    return teams == _other.teams && winners == _other.winners &&
+        decided == _other.decided;
+}
+
+
+// Inequality operator
+bool bracket_picks::operator != (const bracket_picks & _other) const
+{
+    return !(*this == _other);
+}
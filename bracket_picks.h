@@ -0,0 +1,65 @@
+/**
+ * @file bracket_picks.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds the definition for bracket_picks, the compact encoding of the
+ *        winners picked in a bracket.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef BRACKET_PICKS
+#define BRACKET_PICKS
+
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include "utils.h"
+
+/**
+ * @brief The winners of a bracket's games packed one bit per game. Given the
+ *        seeding of the first round, a bracket is fully determined by which
+ *        side won each of its num_teams - 1 games, so that is all this holds.
+ *        Games are numbered by the slot they are played in (0 is the final,
+ *        the children of game i are 2i+1 and 2i+2). Bit i of the winner bits
+ *        is 0 if the first team of game i won and 1 if the second team won,
+ *        and it only means something when bit i of the decided bits is set.
+ *        Games past 64 spill into more words, so a 64-team bracket is a single
+ *        uint64_t and every bracket is num_teams/64 words per bitset. A
+ *        bracket's picks are taken out with bracket::get_picks() and put back
+ *        over the same first round with bracket::set_picks().
+ */
+class bracket_picks : protected utils
+{
+    public:
+        bracket_picks();            // Default constructor
+        bracket_picks(int);         // Param. constructor
+
+        int  num_teams() const;                 // Number of teams in bracket
+        int  num_games() const;                 // Number of games in bracket
+        bool is_decided(int _game) const;       // Checks if game has a winner
+        bool second_won(int _game) const;       // Checks if second team won
+        // Pick the winner of a game (false for the first team, true for second)
+        void set_winner(int _game, bool _second_won);
+        void clear_winner(int _game);           // Mark game as undecided
+        bool is_complete() const;               // Checks if every game is decided
+        // Number of games that both picks decided but picked differently
+        int  differences(const bracket_picks &) const;
+        std::uint64_t hash() const;             // Hash of the picks
+        // Winner bits of a complete bracket of at most 64 teams
+        std::uint64_t to_u64() const;
+        // Complete bracket of at most 64 teams from its winner bits
+        void from_u64(int _num_teams, std::uint64_t _winners);
+        const std::vector<std::uint64_t> & get_winners() const;
+        const std::vector<std::uint64_t> & get_decided() const;
+
+        bool operator == (const bracket_picks &) const;
+        bool operator != (const bracket_picks &) const;
+
+    private:
+        int teams;                              // Number of teams in bracket
+        std::vector<std::uint64_t> winners;     // Bit set if second team won
+        std::vector<std::uint64_t> decided;     // Bit set if game has a winner
+
+        void check_game(int) const;
+};
+
+#endif
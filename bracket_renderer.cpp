@@ -0,0 +1,410 @@
+/**
+ * @file bracket_renderer.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the bracket_renderer class which lays
+ *        out a bracket as text in one buffer.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "bracket_renderer.h"
+using namespace std;
+
+/**
+ * @brief Param. constructor that works out the spacing of the bracket
+ *
+ * @param _source is the bracket to draw
+ */
+bracket_renderer::bracket_renderer(const bracket & _source)
+    : source(_source), empty("---------------"), line(0), line_start(0),
+      max_width(0)
+{
+    int rounds = _source.num_rounds();  // Rounds of games
+
+    // Outermost spots on each side are one column apart per round between
+    gap = (2 * max(rounds - 2, 0) + 1) * SIZE_PAIR_PADDING;
+
+    champion_at[0] = champion_at[1] = -1;
+}
+
+
+/**
+ * @brief lays out the bracket with a header of rounds, the two halves of the
+ *        bracket mirrored, and the final centered under them
+ *
+ * @param _out is filled with the bracket
+ * @throws invalid_argument if the bracket would take over MAX_RENDER_BYTES
+ */
+void bracket_renderer::render(string & _out)
+{
+    int      rounds  = source.num_rounds(); // Rounds of games
+    int      cols    = rounds*2 - 1;        // Number of columns for bracket
+    int      final_padding = gap/2 + SIZE_PAIR_PADDING/2;
+    uint64_t height  = source.num_teams() + 4;
+    uint64_t bytes   = (height + 2) * (gap + 2*SIZE_PAIR_PADDING + 12);
+
+    if (bytes > MAX_RENDER_BYTES)
+        throw invalid_argument("Bracket is too large to draw whole.");
+    start(_out);
+    _out.reserve(bytes);
+    labels.resize(source.num_teams());
+    lines.assign(2 * (source.num_teams() - 1), -1);
+    columns.assign(lines.size(), -1);
+
+    // Header for bracket, rounds mirror around the final
+    for (int i = 0; i < cols; ++i)
+    {
+        string name = source.round_name(i < rounds ? i : cols - 1 - i);
+        _out += name;
+        if ((int)name.size() < SIZE_PAIR_PADDING)
+            _out.append(SIZE_PAIR_PADDING - name.size(), ' ');
+    }
+    end_line("\n", _out);
+    _out.append(max(cols * SIZE_PAIR_PADDING - 2, 1), '=');
+    end_line("\n", _out);
+
+    // Full bracket and finals spot
+    render(1, 2, (rounds - 2) * SIZE_PAIR_PADDING, _out);
+    render_pair(0, final_padding, _out);
+
+    render_champion(final_padding, _out);
+}
+
+
+/**
+ * @brief lays out the games under a slot as a one-sided bracket, with each
+ *        round a column further right. Only rounds _first_round through
+ *        _last_round are shown, and if the slot is in a later round than
+ *        _last_round, each of its games in _last_round is shown in turn. Only
+ *        the slots shown are visited.
+ *
+ * @param _root is the slot at the top of the region (0 is the final)
+ * @param _first_round is the earliest round to show (0 is the first round)
+ * @param _last_round is the latest round to show
+ * @param _out is filled with the region
+ * @throws invalid_argument if the slot doesn't exist or the rounds are out of
+ *         order or past the slot's round
+ */
+void bracket_renderer::render_region(int _root, int _first_round,
+    int _last_round, string & _out)
+{
+    int root_round;     // Round the root slot is played in
+    int below;          // Rounds between the root and _last_round
+
+    if (_root < 0 || _root >= source.num_teams() - 1)
+        throw invalid_argument("No such game in bracket.");
+    root_round  = source.slot_round(_root);
+    _last_round = min(_last_round, root_round);
+    if (_first_round < 0 || _first_round > _last_round)
+        throw invalid_argument("Rounds to show are out of range.");
+    below = root_round - _last_round;
+
+    start(_out);
+    for (int r = _first_round; r <= _last_round; ++r)
+    {
+        string name = source.round_name(r);
+        _out += name;
+        if ((int)name.size() < SIZE_PAIR_PADDING)
+            _out.append(SIZE_PAIR_PADDING - name.size(), ' ');
+    }
+    end_line("\n", _out);
+    _out.append((_last_round - _first_round + 1) * SIZE_PAIR_PADDING - 2, '=');
+    end_line("\n", _out);
+
+    // Games under the root in the last round shown, top to bottom
+    for (int i = 0, first = ((_root + 1) << below) - 1; i < (1 << below); ++i)
+        render_subtree(first + i, _last_round, _first_round, _out);
+
+    if (_root == 0 && _last_round == root_round)
+        render_champion((_last_round - _first_round) * SIZE_PAIR_PADDING, _out);
+}
+
+
+/**
+ * @brief lays out each game a team plays or would play, from its first game
+ *        up to the final, with the winner of each game that's decided. The
+ *        team's first game is found by following it down from the furthest
+ *        slot it reached, so only the slots on its path are visited.
+ *
+ * @param _id is the team to follow
+ * @param _out is filled with the path
+ * @throws invalid_argument if the team isn't in the bracket
+ */
+void bracket_renderer::render_path(team_id _id, string & _out)
+{
+    int slot = source.team_slot(_id);   // Slot on the team's path
+
+    if (slot < 0)
+        throw invalid_argument("Team isn't in the bracket.");
+    while (2*slot + 1 < source.num_teams() - 1)
+        slot = source.get_slot(slot).get_pair().first == _id ? 2*slot + 1 : 2*slot + 2;
+
+    // Matchup is two 17 char spots with " vs " between, then 2 spaces
+    start(_out);
+    _out = "ROUND";
+    _out.resize(SIZE_PAIR_PADDING, ' ');
+    _out += "MATCHUP";
+    _out.resize(SIZE_PAIR_PADDING + 40, ' ');
+    end_line("WINNER\n", _out);
+    _out.append(SIZE_PAIR_PADDING + 40 + 17, '=');
+    end_line("\n", _out);
+
+    for (int r = 0; ; ++r)
+    {
+        const pair<team_id, team_id> & spot = source.get_slot(slot).get_pair();
+        string  name   = source.round_name(r);
+        team_id winner = source.get_champion();
+
+        if (slot > 0)
+        {
+            const pair<team_id, team_id> & next = source.get_slot((slot - 1) / 2).get_pair();
+            winner = slot % 2 ? next.first : next.second;
+        }
+
+        _out += name;
+        if ((int)name.size() < SIZE_PAIR_PADDING)
+            _out.append(SIZE_PAIR_PADDING - name.size(), ' ');
+        _out += '|';
+        render_cell(spot.first, -2, _out);
+        _out += "| vs |";
+        render_cell(spot.second, -2, _out);
+        _out += "|  ";
+        if (winner != NO_TEAM)
+        {
+            _out += '|';
+            render_cell(winner, -2, _out);
+            _out += '|';
+        }
+        end_line("\n", _out);
+
+        if (slot == 0)
+            break;
+        slot = (slot - 1) / 2;
+    }
+}
+
+
+/**
+ * @brief lays out the bracket and writes it to a stream with one write
+ *
+ * @param _out is the stream to write to
+ */
+void bracket_renderer::draw(ostream & _out)
+{
+    string buffer;  // Whole bracket
+
+    render(buffer);
+    _out.write(buffer.data(), buffer.size());
+    _out.flush();
+}
+
+
+/**
+ * @brief private helper that lays out a subtree on the left and its mirror on
+ *        the right, in order, so each matchup sits between the two it came from
+ *
+ * @param _left_root is the left tree's current slot
+ * @param _right_root is the right tree's current slot
+ * @param _padding is the padding to the left of the current slot
+ * @param _out is the buffer to add to
+ */
+void bracket_renderer::render(int _left_root, int _right_root, int _padding,
+    string & _out)
+{
+    if (_left_root >= source.num_teams() - 1)
+        return;
+
+    render(2*_left_root + 1, 2*_right_root + 1, _padding - SIZE_PAIR_PADDING, _out);
+    render_pairs(_left_root, _right_root, _padding, _out);
+    render(2*_left_root + 2, 2*_right_root + 2, _padding - SIZE_PAIR_PADDING, _out);
+}
+
+
+/**
+ * @brief private helper that lays out two mirrored matchups on opposite sides
+ *
+ * @param _left_slot is the slot of the left matchup
+ * @param _right_slot is the slot of the right matchup
+ * @param _left_padding is the padding to the left of the left matchup
+ * @param _out is the buffer to add to
+ */
+void bracket_renderer::render_pairs(int _left_slot, int _right_slot,
+    int _left_padding, string & _out)
+{
+    const pair<team_id, team_id> & left_spot  = source.get_slot(_left_slot).get_pair();
+    const pair<team_id, team_id> & right_spot = source.get_slot(_right_slot).get_pair();
+    int right_padding = max(gap - 2*_left_padding, 0);  // Padding between spots
+
+    // First team of each matchup
+    _out.append(_left_padding, ' ');
+    _out += '|';
+    render_cell(left_spot.first, 2*_left_slot, _out);
+    _out += '|';
+    _out.append(right_padding, ' ');
+    _out += '|';
+    render_cell(right_spot.first, 2*_right_slot, _out);
+    end_line("|\n", _out);
+
+    // Second team of each matchup
+    _out.append(_left_padding, ' ');
+    _out += '|';
+    render_cell(left_spot.second, 2*_left_slot + 1, _out);
+    _out += '|';
+    _out.append(right_padding, ' ');
+    _out += '|';
+    render_cell(right_spot.second, 2*_right_slot + 1, _out);
+    end_line("|\n", _out);
+}
+
+
+/**
+ * @brief private helper that lays out one matchup
+ *
+ * @param _slot is the slot of the matchup
+ * @param _left_padding is the padding to the left of the matchup
+ * @param _out is the buffer to add to
+ */
+void bracket_renderer::render_pair(int _slot, int _left_padding, string & _out)
+{
+    const pair<team_id, team_id> & spot = source.get_slot(_slot).get_pair();
+
+    _out.append(_left_padding, ' ');
+    _out += '|';
+    render_cell(spot.first, 2*_slot, _out);
+    end_line("|\n", _out);
+    _out.append(_left_padding, ' ');
+    _out += '|';
+    render_cell(spot.second, 2*_slot + 1, _out);
+    end_line("|\n", _out);
+}
+
+
+/**
+ * @brief private helper that adds a team's label and records where it went
+ *
+ * @param _id is the team in the cell
+ * @param _cell is the cell (slot*2 + side), -1 for the champion, or -2 for a
+ *        cell that isn't kept track of
+ * @param _out is the buffer to add to
+ */
+void bracket_renderer::render_cell(team_id _id, int _cell, string & _out)
+{
+    int column = _out.size() - line_start;  // Column the label starts at
+
+    if (_cell == -1)
+    {
+        champion_at[0] = line;
+        champion_at[1] = column;
+    }
+    else if (_cell >= 0 && _cell < (int)lines.size())
+    {
+        lines[_cell]   = line;
+        columns[_cell] = column;
+    }
+    _out += label(_id);
+}
+
+
+/**
+ * @brief private helper that lays out a subtree in order, so each matchup
+ *        sits between the two it came from, one column right of them
+ *
+ * @param _slot is the root of the subtree
+ * @param _round is the round of the slot
+ * @param _first_round is the earliest round to show
+ * @param _out is the buffer to add to
+ */
+void bracket_renderer::render_subtree(int _slot, int _round, int _first_round,
+    string & _out)
+{
+    if (_round < _first_round)
+        return;
+
+    render_subtree(2*_slot + 1, _round - 1, _first_round, _out);
+    render_pair(_slot, (_round - _first_round) * SIZE_PAIR_PADDING, _out);
+    render_subtree(2*_slot + 2, _round - 1, _first_round, _out);
+}
+
+
+/**
+ * @brief private helper that lays out the champion under the final once it
+ *        has been decided
+ *
+ * @param _left_padding is the padding to the left of the final
+ * @param _out is the buffer to add to
+ */
+void bracket_renderer::render_champion(int _left_padding, string & _out)
+{
+    if (source.get_champion() == NO_TEAM)
+        return;
+
+    end_line("\n", _out);
+    _out.append(_left_padding, ' ');
+    _out += '|';
+    render_cell(source.get_champion(), -1, _out);
+    end_line("| CHAMPION\n", _out);
+}
+
+
+/**
+ * @brief private helper that empties the buffer and forgets the last layout
+ *
+ * @param _out is the buffer to start
+ */
+void bracket_renderer::start(string & _out)
+{
+    _out.clear();
+    lines.clear();
+    columns.clear();
+    champion_at[0] = champion_at[1] = -1;
+    line       = 0;
+    line_start = 0;
+    max_width  = 0;
+}
+
+
+/**
+ * @brief private helper that finishes the current line
+ *
+ * @param _rest is the end of the line, up to and including its newline
+ * @param _out is the buffer to add to
+ */
+void bracket_renderer::end_line(const char * _rest, string & _out)
+{
+    _out += _rest;
+    max_width  = max(max_width, (int)(_out.size() - line_start - 1));
+    line_start = _out.size();
+    ++line;
+}
+
+
+/**
+ * @brief gives the label of a team, or a blank line for an empty spot. Once
+ *        the whole bracket has been rendered labels are kept by team, before
+ *        that only the labels of the teams drawn so far are kept.
+ *
+ * @param _id is the id of the team
+ * @return const string &: the label
+ */
+const string & bracket_renderer::label(team_id _id) const
+{
+    if (_id == NO_TEAM)
+        return empty;
+    if (_id >= labels.size())
+    {
+        string & found = view_labels[_id];
+        if (found.empty())
+            found = source.get_team(_id).bracket_label();
+        return found;
+    }
+    if (labels[_id].empty())
+        labels[_id] = source.get_team(_id).bracket_label();
+    return labels[_id];
+}
+
+
+int bracket_renderer::height() const { return line; }
+int bracket_renderer::width() const  { return max_width; }
+int bracket_renderer::cell_line(int _slot, int _side) const   { return lines[2*_slot + _side]; }
+int bracket_renderer::cell_column(int _slot, int _side) const { return columns[2*_slot + _side]; }
+int bracket_renderer::champion_line() const   { return champion_at[0]; }
+int bracket_renderer::champion_column() const { return champion_at[1]; }
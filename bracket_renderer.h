@@ -0,0 +1,89 @@
+/**
+ * @file bracket_renderer.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the bracket_renderer class which lays out a
+ *        bracket as text.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef BRACKET_RENDERER
+#define BRACKET_RENDERER
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "bracket.h"
+
+// Most bytes a whole bracket is laid out into (2^18 teams fit)
+static const std::uint64_t MAX_RENDER_BYTES = 1ull << 28;
+
+/**
+ * @brief Lays out a whole bracket into one buffer and writes it out at once.
+ *        The left half of the bracket is drawn down the left of the screen and
+ *        mirrored by the right half, with the final (and champion) centered
+ *        below. Every team's label (see team::bracket_label()) is built the
+ *        first time it's needed and kept, and the buffer is sized up front,
+ *        so a render is only copies into the buffer. Each render also records
+ *        the line and column of every team's cell (and the champion's), so a
+ *        cell can be painted over later (see terminal_view.h). For brackets
+ *        too wide to draw whole there are two views that only visit (and only
+ *        build labels for) the slots they show: a region (the games under one game, over a range of
+ *        rounds, drawn as a one-sided bracket) and the path of one team from
+ *        its first game to the final. The bracket must outlive the renderer,
+ *        and a new renderer is needed if its teams change.
+ */
+class bracket_renderer
+{
+    public:
+        bracket_renderer(const bracket &); // Param. constructor
+
+        // Lay out the bracket into a string (replacing what it held)
+        void render(std::string & _out);
+        // Lay out the bracket and write it to a stream in one write
+        void draw(std::ostream & _out);
+        // Lay out the games under a slot, from _first_round to _last_round
+        // (0 is the first round), in place of the whole bracket
+        void render_region(int _root, int _first_round, int _last_round,
+            std::string & _out);
+        // Lay out every game on a team's path from its first game to the final
+        void render_path(team_id _id, std::string & _out);
+        // Label of a team, or of an empty spot for NO_TEAM
+        const std::string & label(team_id) const;
+
+        // Layout of the last render(), lines and columns count from 0
+        int  height() const;                    // Lines in the bracket
+        int  width() const;                     // Chars in the longest line
+        int  cell_line(int _slot, int _side) const;     // Side 0 is first team
+        int  cell_column(int _slot, int _side) const;
+        int  champion_line() const;             // -1 if no champion was drawn
+        int  champion_column() const;
+
+    private:
+        const bracket &          source;    // Bracket being drawn
+        mutable std::vector<std::string> labels;    // Label of each team, once built
+        // Labels drawn by the region and path views before a whole render
+        mutable std::unordered_map<team_id, std::string> view_labels;
+        std::string              empty;     // Label of an empty spot
+        int                      gap;       // Padding between outermost spots
+        std::vector<int>         lines;     // Line of each cell, [slot*2 + side]
+        std::vector<int>         columns;   // Column of each cell
+        int                      champion_at[2];    // Line and column of champion
+        int                      line;      // Line being laid out
+        std::size_t              line_start;    // Offset of line in the buffer
+        int                      max_width; // Chars in the longest line
+
+        void render(int _left_root, int _right_root, int _padding,
+            std::string & _out);
+        void render_pairs(int _left_slot, int _right_slot, int _left_padding,
+            std::string & _out);
+        void render_pair(int _slot, int _left_padding, std::string & _out);
+        void render_subtree(int _slot, int _round, int _first_round,
+            std::string & _out);
+        void render_champion(int _left_padding, std::string & _out);
+        void start(std::string & _out);
+        void render_cell(team_id _id, int _cell, std::string & _out);
+        void end_line(const char * _rest, std::string & _out);
+};
+
+#endif
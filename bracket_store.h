@@ -0,0 +1,44 @@
+/**
+ * @file bracket_store.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the bracket_store interface, a place saved
+ *        brackets are kept by name.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef BRACKET_STORE
+#define BRACKET_STORE
+
+#include <string>
+#include <vector>
+#include "bracket.h"
+
+/**
+ * @brief Where saved brackets are kept, by name. There are three: a directory
+ *        with a file per bracket (directory_store.h, resources/saved), brackets
+ *        held in memory for tests and benchmarks (memory_store.h), and one
+ *        packed archive file holding many brackets (archive_store.h). Saves may
+ *        be buffered by a store until commit() (or the store is destroyed).
+ */
+class bracket_store
+{
+    public:
+        virtual ~bracket_store() {}             // Destructor
+
+        // Names of every bracket, sorted, throws if there are none
+        virtual void get_files(std::vector<std::string> & _names) = 0;
+        // Checks if a bracket is in the store
+        virtual bool contains(const std::string & _name) = 0;
+        // Teams in a bracket, without loading it (0 if it isn't a bracket)
+        virtual int  num_teams(const std::string & _name) = 0;
+        // Load a bracket, throws if it isn't in the store
+        virtual void load(const std::string & _name, bracket & _target) = 0;
+        // Save a bracket, replacing any bracket of the same name
+        virtual void save(const std::string & _name, bracket & _source) = 0;
+        // Remove a bracket (false if it isn't in the store)
+        virtual bool remove(const std::string & _name) = 0;
+        // Make every save and remove so far last
+        virtual void commit() {}
+};
+
+#endif
@@ -0,0 +1,328 @@
+/**
+ * @file catalog.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the catalog class, a persistent index of
+ *        the bracket files in one directory.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "catalog.h"
+using namespace std;
+
+static const char *  CATALOG_MAGIC   = "CATALOG 1";  // First line of index file
+static const int64_t RACY_SECONDS    = 2;            // Write times to recheck
+
+/**
+ * @brief Param. constructor, the index file isn't read until the catalog is
+ *        first used
+ *
+ * @param _directory is the directory to index
+ * @param _index_file is the file to keep the index in between runs
+ */
+catalog::catalog(const string & _directory, const string & _index_file) :
+    directory(_directory), index_file(_index_file), loaded(false), dir_mtime(0)
+{}
+
+
+/**
+ * @brief brings the catalog up to date. If the directory's write time hasn't
+ *        moved since the last scan, nothing was added, removed or replaced and
+ *        the directory isn't read at all. Otherwise it is listed again, and
+ *        only the files with a new size or write time are read.
+ */
+void catalog::refresh()
+{
+    error_code   err;
+    int64_t      now = ticks(filesystem::file_time_type::clock::now());
+    int64_t      trusted;   // Write times before this can't change unseen
+    int64_t      mtime;
+
+    if (!loaded)
+    {
+        load_index();
+        loaded = true;
+    }
+
+    mtime = ticks(filesystem::last_write_time(directory, err));
+    if (err)
+    {
+        // Directory is gone, so it holds nothing
+        if (!entries.empty() || dir_mtime != 0)
+        {
+            entries.clear();
+            by_name.clear();
+            dir_mtime = 0;
+        }
+        return;
+    }
+    if (mtime == dir_mtime)
+        return;
+
+    trusted = now - chrono::duration_cast<filesystem::file_time_type::duration>(
+        chrono::seconds(RACY_SECONDS)).count();
+    // A directory or file written too close to the scan is scanned again
+    dir_mtime = rescan(trusted) || mtime >= trusted ? 0 : mtime;
+    save_index();
+}
+
+
+/**
+ * @brief gets the names of every file in the directory, sorted
+ *
+ * @param _files is a std::vector<std::string> to fill (must be empty)
+ * @throws invalid_argument if the vector isn't empty or there are no files
+ */
+void catalog::get_files(vector<string> & _files)
+{
+    if (_files.size() > 0)
+        throw invalid_argument("Vector argument is non-empty");
+    refresh();
+    for (const catalog_entry & entry : entries)
+        _files.push_back(entry.name);
+
+    // Throw error if empty directory
+    if (_files.size() < 1)
+        throw invalid_argument("No files in the selection, please try adding one to " +
+            directory + ".");
+}
+
+
+/**
+ * @brief Checks if a file name exists in the directory
+ *
+ * @param _name is the file name to check for
+ * @return true if the file exists
+ * @return false if the file doesn't exist
+ */
+bool catalog::contains(const string & _name)
+{
+    refresh();
+    return by_name.count(_name) > 0;
+}
+
+
+/**
+ * @brief Returns what is known about a file
+ *
+ * @param _name is the file name to look up
+ * @return const catalog_entry *: the file's entry, nullptr if it doesn't exist
+ */
+const catalog_entry * catalog::find(const string & _name)
+{
+    refresh();
+
+    auto found = by_name.find(_name);
+    return found == by_name.end() ? nullptr : &entries[found->second];
+}
+
+
+int catalog::num_files()
+{
+    refresh();
+    return entries.size();
+}
+
+
+/**
+ * @brief private helper that reads the index file kept by the last run. A
+ *        missing or damaged index is ignored, and the directory is scanned
+ *        from scratch.
+ */
+void catalog::load_index()
+{
+    ifstream      in(index_file);
+    string        line;
+    catalog_entry entry;
+    bool          good;
+
+    entries.clear();
+    if (!getline(in, line) || line != CATALOG_MAGIC || !(in >> dir_mtime))
+    {
+        dir_mtime = 0;
+        return;
+    }
+    in.ignore();
+
+    // Each line is: size mtime teams hash name
+    while (getline(in, line))
+    {
+        const char * field = line.c_str();
+        char *       end;
+
+        entry.size  = strtoull(field, &end, 10);
+        good        = end != field && *end == ' ';
+        entry.mtime = strtoll(field = end, &end, 10);
+        good        = good && end != field && *end == ' ';
+        entry.teams = strtol(field = end, &end, 10);
+        good        = good && end != field && *end == ' ';
+        entry.hash  = strtoull(field = end, &end, 10);
+        good        = good && end != field && *end == ' ' && end[1] != '\0';
+        if (!good)
+        {
+            entries.clear();
+            dir_mtime = 0;
+            return;
+        }
+        entry.name.assign(end + 1);
+        entries.push_back(entry);
+    }
+    sort(entries.begin(), entries.end(),
+        [](const catalog_entry & a, const catalog_entry & b) { return a.name < b.name; });
+    index_names();
+}
+
+
+/**
+ * @brief private helper that writes the index to a temporary file and renames
+ *        it over the index file, so a crash never leaves half an index. The
+ *        index is only a cache, so failing to write it is ignored.
+ */
+void catalog::save_index() const
+{
+    string   temp_file = index_file + ".tmp";
+    ofstream out(temp_file, ios::trunc);
+
+    if (!out)
+        return;
+    out << CATALOG_MAGIC << '\n' << dir_mtime << '\n';
+    for (const catalog_entry & entry : entries)
+        out << entry.size << ' ' << entry.mtime << ' ' << entry.teams << ' '
+            << entry.hash << ' ' << entry.name << '\n';
+    out.close();
+
+    error_code err;
+    if (out)
+        filesystem::rename(temp_file, index_file, err);
+    else
+        filesystem::remove(temp_file, err);
+}
+
+
+/**
+ * @brief private helper that lists the directory again. A file keeps its old
+ *        entry if its size and write time are unchanged, and is read again
+ *        otherwise.
+ *
+ * @param _trusted is the time after which a write time may still change
+ *        without moving (these are recorded as 0 so they are read next time)
+ * @return true if any file had a write time after _trusted
+ */
+bool catalog::rescan(int64_t _trusted)
+{
+    vector<catalog_entry> scanned;  // Files in the directory now
+    error_code            err;
+    bool                  racy = false;
+
+    for (const auto & file : filesystem::directory_iterator(directory, err))
+    {
+        // Edit logs and saves being written belong to another file
+        if (!file.is_regular_file(err) || file.path().extension() == ".log" ||
+            file.path().extension() == ".tmp")
+            continue;
+
+        catalog_entry entry;
+        entry.name  = file.path().filename().string();
+        entry.size  = file.file_size(err);
+        if (err)
+            continue;
+        entry.mtime = ticks(file.last_write_time(err));
+        if (err)
+            continue;
+
+        auto old = by_name.find(entry.name);
+        if (old != by_name.end() && entries[old->second].size == entry.size &&
+            entries[old->second].mtime == entry.mtime)
+        {
+            entry.teams = entries[old->second].teams;
+            entry.hash  = entries[old->second].hash;
+        }
+        else
+            describe(entry);
+
+        if (entry.mtime >= _trusted)
+        {
+            entry.mtime = 0;
+            racy        = true;
+        }
+        scanned.push_back(entry);
+    }
+
+    sort(scanned.begin(), scanned.end(),
+        [](const catalog_entry & a, const catalog_entry & b) { return a.name < b.name; });
+    entries.swap(scanned);
+    index_names();
+    return racy;
+}
+
+
+/**
+ * @brief private helper that reads a file to hash it and count its teams. A
+ *        binary save holds the number in its header. A new bracket has one
+ *        team per line, and a text save has one game per line (a team less),
+ *        which is told apart by the first line holding two teams.
+ *
+ * @param _entry is the entry to fill, with its name set
+ */
+void catalog::describe(catalog_entry & _entry) const
+{
+    _entry.teams = 0;
+    _entry.hash  = 0;
+    try {
+        mapped_file  file(directory + "/" + _entry.name);  // Whole file in memory
+        const char * bytes = file.data();
+        size_t       size  = file.size();
+
+        _entry.hash = checksum(bytes, size);
+
+        // Binary save
+        if (size >= sizeof(saved_header) &&
+            memcmp(bytes, SAVED_MAGIC, sizeof(SAVED_MAGIC)) == 0)
+        {
+            saved_header header;
+            memcpy(&header, bytes, sizeof(header));
+            _entry.teams = header.num_teams;
+            return;
+        }
+
+        // Text file, count non-empty lines and the fields of the first
+        int  lines       = 0;
+        int  separators  = 0;
+        bool blank       = true;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (bytes[i] == '\n')
+            {
+                lines += !blank;
+                blank  = true;
+            }
+            else if (bytes[i] != '\r')
+            {
+                blank = false;
+                if (bytes[i] == ';' && lines == 0)
+                    ++separators;
+            }
+        }
+        lines += !blank;
+        _entry.teams = lines + (separators > 4);
+    }
+    // Unreadable files are listed, but as no bracket
+    catch (...) {}
+}
+
+
+// private helper that maps each name to its entry
+void catalog::index_names()
+{
+    by_name.clear();
+    by_name.reserve(entries.size());
+    for (int i = 0; i < (int)entries.size(); ++i)
+        by_name.emplace(entries[i].name, i);
+}
+
+
+// private helper that turns a write time into a number for the index file
+int64_t catalog::ticks(filesystem::file_time_type _time)
+{
+    return _time.time_since_epoch().count();
+}
@@ -0,0 +1,83 @@
+/**
+ * @file catalog.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the catalog class, a persistent index of the
+ *        bracket files in one directory.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef CATALOG
+#define CATALOG
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include "mapped_file.h"
+#include "saved_format.h"
+#include "utils.h"
+
+/**
+ * @brief What the catalog knows about one file
+ */
+struct catalog_entry
+{
+    std::string   name;     // File name in the directory
+    std::uint64_t size;     // Size in bytes
+    std::int64_t  mtime;    // Last write time in file clock ticks (0 to recheck)
+    int           teams;    // Teams in the bracket (0 if it isn't one)
+    std::uint64_t hash;     // utils::checksum() of the contents
+};
+
+
+/**
+ * @brief An index of the files in one directory (such as resources/saved) that
+ *        is kept in an index file between runs. Each file has its name, size,
+ *        last write time, number of teams and a hash of its contents. refresh()
+ *        only looks in the directory if the directory's own last write time
+ *        moved, which happens whenever a file is added, removed or replaced,
+ *        and then only reads the files whose size or write time changed. Times
+ *        too close to the scan to be trusted (the clock may not have ticked
+ *        since) are recorded as 0, so they are checked again next time. Names
+ *        are kept sorted, and looked up in a hash map. Edit logs (.log) and
+ *        saves being written (.tmp) aren't brackets and are left out.
+ */
+class catalog : protected utils
+{
+    public:
+        // Param. constructor, the index is kept in _index_file
+        catalog(const std::string & _directory, const std::string & _index_file);
+
+        // Bring the catalog up to date with the directory
+        void refresh();
+        // Names of every file, sorted, throws if there are none
+        void get_files(std::vector<std::string> & _files);
+        // Checks if a file is in the directory
+        bool contains(const std::string & _name);
+        // What is known about a file (nullptr if it isn't in the directory)
+        const catalog_entry * find(const std::string & _name);
+        int  num_files();                       // Number of files in directory
+
+    private:
+        std::string  directory;     // Directory indexed
+        std::string  index_file;    // File the index is kept in
+        bool         loaded;        // If the index file has been read
+        std::int64_t dir_mtime;     // Directory's write time at the last scan
+        std::vector<catalog_entry> entries;     // Files sorted by name
+        std::unordered_map<std::string, int> by_name;   // Index of each name
+
+        void load_index();
+        void save_index() const;
+        bool rescan(std::int64_t _trusted);
+        void describe(catalog_entry & _entry) const;
+        void index_names();
+        static std::int64_t ticks(std::filesystem::file_time_type _time);
+};
+
+#endif
@@ -0,0 +1,320 @@
+/**
+ * @file cow_array.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the cow_array class template, a paged array
+ *        whose copies share pages until they are written.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef COW_ARRAY
+#define COW_ARRAY
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+// log2 of the fewest elements in a page of a cow_array
+static const std::size_t COW_MIN_PAGE_BITS = 4;
+// Bytes set aside in an arena for the shared count of each page
+static const std::size_t COW_COUNT_BYTES = 64;
+
+/**
+ * @brief One block of memory that every page made by one cow_array::assign()
+ *        is carved out of, along with the shared counts of the pages, so an
+ *        array is built with one allocation however many pages it has. Each
+ *        piece taken keeps the arena alive, and it is freed once the last is
+ *        released, so a page a copy still shares keeps the whole arena. A
+ *        piece that doesn't fit is allocated on its own instead.
+ */
+class cow_arena
+{
+    public:
+        // Make an arena for _pages pages holding _bytes bytes in all
+        static cow_arena * create(std::size_t _bytes, std::size_t _pages);
+        // Take a piece of the arena
+        void * take(std::size_t _bytes, std::size_t _align);
+        // Give back a piece, freeing the arena after the last one
+        void   release(void * _piece);
+
+    private:
+        std::atomic<std::size_t> live;  // Pieces taken and not yet released
+        char *                   next;  // Start of the room left
+        char *                   end;   // End of the arena
+};
+
+
+/**
+ * @brief Hands the shared counts of cow_array pages out of their arena.
+ */
+template <class U>
+struct cow_arena_allocator
+{
+    using value_type = U;
+
+    cow_arena * arena;      // Arena the pages came out of
+
+    explicit cow_arena_allocator(cow_arena * _arena) : arena(_arena) {}
+    template <class V>
+    cow_arena_allocator(const cow_arena_allocator<V> & _other) : arena(_other.arena) {}
+
+    U * allocate(std::size_t _n)
+    {
+        return static_cast<U *>(arena->take(_n * sizeof(U), alignof(U)));
+    }
+    void deallocate(U * _piece, std::size_t) { arena->release(_piece); }
+
+    template <class V>
+    bool operator == (const cow_arena_allocator<V> & _other) const { return arena == _other.arena; }
+    template <class V>
+    bool operator != (const cow_arena_allocator<V> & _other) const { return arena != _other.arena; }
+};
+
+
+/**
+ * @brief A fixed size array split into pages, each held by a shared pointer.
+ *        Copying the array only copies the page pointers, so copies share
+ *        every page. Writing an element through write() first clones its page
+ *        if another array still shares it, so a copy that is edited a few
+ *        times only owns the few pages it wrote. Reads never clone. Pages hold
+ *        about the square root of the array's length (2^COW_MIN_PAGE_BITS at
+ *        least), so a small array is split finely enough that a copy clones a
+ *        few dozen elements on a write, and a large one still clones little
+ *        next to its size. The last page only holds the elements left over.
+ *        assign() makes every page out of one arena (see cow_arena), and
+ *        refills the pages in place when this array owns them all alone, so
+ *        rebuilding an array of the same size allocates nothing. A bracket
+ *        keeps its slots and seed index in cow_arrays and shares its team
+ *        table, so copying a bracket is a cheap fork.
+ */
+template <class T>
+class cow_array
+{
+    public:
+        cow_array() : count(0), capacity(0), page_bits(COW_MIN_PAGE_BITS) {}
+
+        // Resize to _size elements, each set to _value
+        void assign(std::size_t _size, const T & _value);
+        // Drop every element, keeping the pages owned alone for assign()
+        void clear();
+        std::size_t size() const { return count; }
+        // Read an element, never clones
+        const T & operator [] (std::size_t _i) const
+        {
+            return pages[_i >> page_bits][_i & ((std::size_t(1) << page_bits) - 1)];
+        }
+        // Element to write, cloning its page first if it is shared
+        T & write(std::size_t _i);
+        // Pages shared with another array
+        std::size_t shared_pages() const;
+        // Elements in each page but the last
+        std::size_t page_size() const { return std::size_t(1) << page_bits; }
+
+    private:
+        std::vector<std::shared_ptr<T[]>> pages;    // Pages in order
+        std::size_t                       count;    // Number of elements
+        std::size_t                       capacity; // Elements the pages hold
+        std::size_t                       page_bits; // log2 of elements in a page
+
+        // Elements in a page when the pages hold _count elements
+        std::size_t page_length(std::size_t _page, std::size_t _count) const
+        {
+            return std::min(page_size(), _count - (_page << page_bits));
+        }
+        // log2 of the elements in a page of an array of _size elements
+        static std::size_t bits_for(std::size_t _size)
+        {
+            std::size_t bits = 0;
+
+            while ((std::size_t(1) << (2 * bits)) < _size)
+                ++bits;
+            return std::max(bits, COW_MIN_PAGE_BITS);
+        }
+        bool owns_all() const;
+};
+
+
+/**
+ * @brief makes an arena with room for pages of _bytes bytes in all, with the
+ *        shared count of each page and the padding to align them
+ *
+ * @param _bytes is the bytes of every page together
+ * @param _pages is the number of pages
+ * @return cow_arena *: the arena, freed once every piece taken is released
+ */
+inline cow_arena * cow_arena::create(std::size_t _bytes, std::size_t _pages)
+{
+    std::size_t room   = _bytes + _pages * (COW_COUNT_BYTES + 2 * alignof(std::max_align_t));
+    char *      memory = static_cast<char *>(::operator new(sizeof(cow_arena) + room));
+    cow_arena * arena  = new (memory) cow_arena;
+
+    arena->live = 0;
+    arena->next = memory + sizeof(cow_arena);
+    arena->end  = arena->next + room;
+    return arena;
+}
+
+
+/**
+ * @brief takes the next piece of the arena, or allocates it on its own if
+ *        the arena has no room left for it
+ *
+ * @param _bytes is the size of the piece
+ * @param _align is the alignment of the piece
+ * @return void *: the piece
+ */
+inline void * cow_arena::take(std::size_t _bytes, std::size_t _align)
+{
+    std::size_t pad = (_align - reinterpret_cast<std::uintptr_t>(next) % _align) % _align;
+
+    if ((std::size_t)(end - next) < pad + _bytes)
+        return ::operator new(_bytes);
+    next += pad;
+    ++live;
+    return std::exchange(next, next + _bytes);
+}
+
+
+/**
+ * @brief gives back a piece taken from the arena. The arena is freed when the
+ *        last piece is given back.
+ *
+ * @param _piece is the piece
+ */
+inline void cow_arena::release(void * _piece)
+{
+    char * piece = static_cast<char *>(_piece);
+
+    if (piece < reinterpret_cast<char *>(this + 1) || piece >= end)
+    {
+        ::operator delete(_piece);
+        return;
+    }
+    if (--live == 0)
+    {
+        this->~cow_arena();
+        ::operator delete(static_cast<void *>(this));
+    }
+}
+
+
+/**
+ * @brief resizes the array and sets every element. If this array owns every
+ *        page alone and keeps its size, the pages are filled in place.
+ *        Otherwise they are all made again out of one new arena.
+ *
+ * @param _size is the number of elements
+ * @param _value is the value of every element
+ */
+template <class T>
+void cow_array<T>::assign(std::size_t _size, const T & _value)
+{
+    cow_arena * arena;      // Arena the new pages come out of
+
+    if (_size == capacity && owns_all())
+    {
+        for (std::size_t i = 0; i < pages.size(); ++i)
+            std::fill(pages[i].get(), pages[i].get() + page_length(i, capacity), _value);
+        count = _size;
+        return;
+    }
+
+    page_bits = bits_for(_size);
+    pages.clear();
+    pages.resize((_size + page_size() - 1) >> page_bits);
+    count    = _size;
+    capacity = _size;
+    if (pages.empty())
+        return;
+
+    arena = cow_arena::create(_size * sizeof(T), pages.size());
+    for (std::size_t i = 0; i < pages.size(); ++i)
+    {
+        std::size_t length = page_length(i, _size);
+        T *         page   = static_cast<T *>(arena->take(length * sizeof(T), alignof(T)));
+
+        std::uninitialized_fill_n(page, length, _value);
+        pages[i] = std::shared_ptr<T[]>(page, [arena, length](T * _page) {
+            std::destroy_n(_page, length);
+            arena->release(_page);
+        }, cow_arena_allocator<T>(arena));
+    }
+}
+
+
+/**
+ * @brief drops every element. Pages this array owns alone are kept for the
+ *        next assign() to refill, so clearing and rebuilding an array of the
+ *        same size allocates nothing. Shared pages are let go.
+ */
+template <class T>
+void cow_array<T>::clear()
+{
+    for (std::shared_ptr<T[]> & p : pages)
+        if (p.use_count() > 1)
+            p.reset();
+    count = 0;
+}
+
+
+/**
+ * @brief returns an element to write. If its page is shared with another
+ *        array, the page is cloned first so the other array doesn't see the
+ *        write.
+ *
+ * @param _i is the index of the element
+ * @return T &: the element, in a page this array owns alone
+ */
+template <class T>
+T & cow_array<T>::write(std::size_t _i)
+{
+    std::shared_ptr<T[]> & p = pages[_i >> page_bits];
+
+    if (p.use_count() > 1)
+    {
+        std::size_t          length = page_length(_i >> page_bits, capacity);
+        std::shared_ptr<T[]> clone(new T[length]);
+
+        std::copy(p.get(), p.get() + length, clone.get());
+        p = std::move(clone);
+    }
+    return p[_i & (page_size() - 1)];
+}
+
+
+/**
+ * @brief counts the pages shared with another array, such as a copy that
+ *        hasn't written them yet
+ *
+ * @return size_t: the number of shared pages
+ */
+template <class T>
+std::size_t cow_array<T>::shared_pages() const
+{
+    std::size_t shared = 0;
+
+    for (const std::shared_ptr<T[]> & p : pages)
+        shared += p.use_count() > 1;
+    return shared;
+}
+
+/**
+ * @brief private helper that checks this array owns every one of its pages
+ *        alone, so they can be written in place
+ *
+ * @return true if no page is missing or shared
+ */
+template <class T>
+bool cow_array<T>::owns_all() const
+{
+    for (const std::shared_ptr<T[]> & p : pages)
+        if (!p || p.use_count() > 1)
+            return false;
+    return true;
+}
+
+#endif
\ No newline at end of file
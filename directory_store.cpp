@@ -0,0 +1,94 @@
+/**
+ * @file directory_store.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the directory_store class, a bracket
+ *        store with one file per bracket in a directory.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "directory_store.h"
+using namespace std;
+
+/**
+ * @brief Param. constructor
+ *
+ * @param _directory is the directory the brackets are kept in
+ * @param _index_file is the file its catalog is kept in between runs
+ */
+directory_store::directory_store(const string & _directory, const string & _index_file) :
+    directory(_directory), files(_directory, _index_file)
+{}
+
+
+void directory_store::get_files(vector<string> & _names)
+{
+    files.get_files(_names);
+}
+
+
+bool directory_store::contains(const string & _name)
+{
+    return files.contains(_name);
+}
+
+
+int directory_store::num_teams(const string & _name)
+{
+    const catalog_entry * listed = files.find(_name);
+    return listed ? listed->teams : 0;
+}
+
+
+/**
+ * @brief loads a bracket from its file, replaying its edit log
+ *
+ * @param _name is the name of the bracket
+ * @param _target is the bracket to load into
+ * @throws invalid_argument if the file doesn't exist or isn't a valid save
+ */
+void directory_store::load(const string & _name, bracket & _target)
+{
+    _target.fill_bracket(path(_name));
+}
+
+
+/**
+ * @brief saves a bracket to its file, only appending its changes if it was
+ *        loaded from that file
+ *
+ * @param _name is the name of the bracket
+ * @param _source is the bracket to save
+ */
+void directory_store::save(const string & _name, bracket & _source)
+{
+    _source.save_changes(path(_name));
+}
+
+
+/**
+ * @brief removes a bracket's file and its edit log. It holds the lock on saved
+ *        files (see saved_file_lock()) like every other reader and writer of
+ *        them, and a bracket still folding its edit log into this file only
+ *        writes over a save that exists, so the file stays removed.
+ *
+ * @param _name is the name of the bracket
+ * @return true if the file was removed
+ * @return false if there was no such file
+ */
+bool directory_store::remove(const string & _name)
+{
+    string            file = path(_name);   // File of the bracket
+    lock_guard<mutex> lock(saved_file_lock());
+
+    if (std::remove(file.c_str()) != 0)
+        return false;
+    std::remove((file + ".log").c_str());
+    return true;
+}
+
+
+// private helper that gives the file a bracket is kept in
+string directory_store::path(const string & _name) const
+{
+    return directory + "/" + _name;
+}
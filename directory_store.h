@@ -0,0 +1,45 @@
+/**
+ * @file directory_store.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the directory_store class, a bracket store
+ *        with one file per bracket in a directory.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef DIRECTORY_STORE
+#define DIRECTORY_STORE
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include "bracket_store.h"
+#include "catalog.h"
+
+/**
+ * @brief Keeps each bracket as a file named after it in a directory (such as
+ *        resources/saved), listed through a catalog of the directory (see
+ *        catalog.h). Loads and saves go through fill_bracket() and
+ *        save_changes(), so a save only appends the bracket's changes to its
+ *        edit log. Every save lasts as soon as it is made.
+ */
+class directory_store : public bracket_store
+{
+    public:
+        // Param. constructor, the catalog is kept in _index_file
+        directory_store(const std::string & _directory, const std::string & _index_file);
+
+        void get_files(std::vector<std::string> & _names) override;
+        bool contains(const std::string & _name) override;
+        int  num_teams(const std::string & _name) override;
+        void load(const std::string & _name, bracket & _target) override;
+        void save(const std::string & _name, bracket & _source) override;
+        bool remove(const std::string & _name) override;
+
+    private:
+        std::string directory;  // Directory the brackets are in
+        catalog     files;      // Index of the directory
+
+        std::string path(const std::string & _name) const;
+};
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @file edit_journal.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the edit_journal class which keeps the
+ *        undo/redo history of a bracket.
+ * 
+ * @copyright Copyright (c) 2022
+ */
+#include "edit_journal.h"
+using namespace std;
+
+// Default constructor
+edit_journal::edit_journal() : applied(0)
+{}
+
+
+/**
+ * @brief adds a write at the cursor. Writes that were undone can't be redone
+ *        after a new write, so they are dropped.
+ * 
+ * @param _edit is the write that was made
+ */
+void edit_journal::record(const slot_edit & _edit)
+{
+    edits.resize(applied);
+    edits.push_back(_edit);
+    ++applied;
+}
+
+
+bool edit_journal::can_undo() const { return applied > 0; }
+bool edit_journal::can_redo() const { return applied < edits.size(); }
+
+
+/**
+ * @brief steps the cursor back over the last applied write
+ * 
+ * @return const slot_edit &: the write for the bracket to revert
+ * @throws out_of_range if no write is applied
+ */
+const slot_edit & edit_journal::undo()
+{
+    if (!can_undo())
+        throw out_of_range("Nothing to undo.");
+    return edits[--applied];
+}
+
+
+/**
+ * @brief steps the cursor forward over the next undone write
+ * 
+ * @return const slot_edit &: the write for the bracket to make again
+ * @throws out_of_range if no write was undone
+ */
+const slot_edit & edit_journal::redo()
+{
+    if (!can_redo())
+        throw out_of_range("Nothing to redo.");
+    return edits[applied++];
+}
+
+
+size_t edit_journal::position() const { return applied; }
+size_t edit_journal::size() const     { return edits.size(); }
+
+
+// Forgets every write, such as when the bracket is rebuilt
+void edit_journal::clear()
+{
+    edits.clear();
+    applied = 0;
+}
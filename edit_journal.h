@@ -0,0 +1,62 @@
+/**
+ * @file edit_journal.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the edit_journal class, the undo/redo history of
+ *        the edits made to a bracket.
+ * 
+ * @copyright Copyright (c) 2022
+ */
+#ifndef EDIT_JOURNAL
+#define EDIT_JOURNAL
+
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include "team.h"
+
+/**
+ * @brief One write to a spot of a bracket slot. Slot -1 is the champion.
+ */
+struct slot_edit
+{
+    int     slot;       // Slot written (-1 for the champion)
+    bool    second;     // If the second spot of the slot was written
+    team_id old_team;   // Team in the spot before the write
+    team_id new_team;   // Team in the spot after the write
+};
+
+
+/**
+ * @brief The history of writes to a bracket's slots, oldest first, with a
+ *        cursor at the number of writes currently applied. Undoing moves the
+ *        cursor back one write and redoing moves it forward one, each in O(1),
+ *        and the bracket reverts or replays the write it is handed. Recording
+ *        a new write drops the writes that had been undone. A position from
+ *        position() marks a point to roll back to later without copying the
+ *        bracket. Every advance of a bracket is one write to a slot, so
+ *        bracket::undo(), bracket::redo() and bracket::rollback() step through
+ *        its advances in place.
+ */
+class edit_journal
+{
+    public:
+        edit_journal();                         // Default constructor
+
+        // Adds a write after the cursor, dropping any undone writes
+        void record(const slot_edit & _edit);
+        bool can_undo() const;                  // Checks if a write is applied
+        bool can_redo() const;                  // Checks if a write was undone
+        // Steps back over the last applied write and returns it
+        const slot_edit & undo();
+        // Steps forward over the next undone write and returns it
+        const slot_edit & redo();
+        std::size_t position() const;           // Number of writes applied
+        std::size_t size() const;               // Number of writes recorded
+        void clear();                           // Forgets every write
+
+    private:
+        std::vector<slot_edit> edits;   // Writes, oldest first
+        std::size_t            applied; // Writes before the cursor
+};
+
+#endif
@@ -0,0 +1,350 @@
+/**
+ * @file fixed_bracket.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the fixed_bracket class template, a bracket
+ *        whose number of teams is known at compile time.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef FIXED_BRACKET
+#define FIXED_BRACKET
+
+#include <array>
+#include <type_traits>
+#include "bracket.h"
+
+// Rounds of games in a bracket of _teams teams (2^x), or floor(log2(_teams))
+constexpr int fixed_rounds(int _teams)
+{
+    int rounds = 0;
+
+    for (; _teams > 1; _teams /= 2)
+        ++rounds;
+    return rounds;
+}
+
+
+// Seed at every first round position of N teams, see seed_order.h
+template <int N>
+constexpr std::array<int, N> fixed_seed_order()
+{
+    std::array<int, N> seeds{};
+
+    seeds[0] = 1;
+    for (int size = 2; size <= N; size *= 2)
+        for (int i = size - 1; i >= 0; --i)
+            seeds[i] = seed_order::grow(size, i, seeds[i >> 1]);
+    return seeds;
+}
+
+
+// Round of every slot of N teams, see bracket::slot_round()
+template <int N>
+constexpr std::array<int, N - 1> fixed_slot_rounds()
+{
+    std::array<int, N - 1> rounds{};
+
+    for (int i = 0; i < N - 1; ++i)
+        rounds[i] = fixed_rounds(N) - 1 - fixed_rounds(i + 1);
+    return rounds;
+}
+
+
+/**
+ * @brief The games of a bracket of N teams with the size built in: slots in a
+ *        std::array in the same heap order as bracket (the final is slot 0 and
+ *        the children of slot i are 2i+1 and 2i+2), a seed index that needs no
+ *        heap, and geometry and a seeding order worked out by the compiler.
+ *        It only holds team ids, not the team table, and has the same game
+ *        API as bracket. A fixed bracket is loaded from and stored into a
+ *        bracket with the same first round, which does the file I/O and
+ *        drawing in the usual formats. The simulator and pool use these sizes
+ *        for their inner loops (see with_fixed_size()).
+ */
+template <int N>
+class fixed_bracket
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "Number of teams isn't power of two.");
+    static_assert(N <= MAX_TEAMS, "Too many teams for one bracket.");
+
+    public:
+        static constexpr int TEAMS  = N;                    // Number of teams
+        static constexpr int SPOTS  = N - 1;                // Slots in the tree
+        static constexpr int ROUNDS = fixed_rounds(N);      // Rounds of games
+        // Seed at each first round position (0 is the top)
+        static constexpr std::array<int, N> SEEDS = fixed_seed_order<N>();
+        // Round each slot is played in (0 is the first round)
+        static constexpr std::array<int, N - 1> SLOT_ROUNDS = fixed_slot_rounds<N>();
+
+        fixed_bracket();                    // Default constructor
+        fixed_bracket(const bracket &);     // Param. constructor
+
+        // Put the games into a bracket with the same first round
+        void store(bracket & _target) const;
+        // Advance a team by its seed
+        bool advance_team(int _seed);
+        // Get a slot of the heap-ordered tree (0 is the final)
+        const node & get_slot(int _slot) const { return slots[_slot]; }
+        // Winner of the game in a slot (NO_TEAM if it hasn't been decided)
+        team_id winner(int _slot) const;
+        // Slot a team has advanced furthest to (-1 if not in bracket)
+        int  team_slot(team_id _id) const;
+        // Winner of the final (NO_TEAM if it hasn't been decided)
+        team_id get_champion() const { return champion; }
+        // Winner of every game packed one bit per game
+        bracket_picks get_picks() const;
+        // Replace every game after the first round with the winners in picks
+        void set_picks(const bracket_picks & _picks);
+
+        static constexpr int num_teams()  { return TEAMS; }
+        static constexpr int num_rounds() { return ROUNDS; }
+        static constexpr int slot_round(int _slot) { return SLOT_ROUNDS[_slot]; }
+        static constexpr int round_first_slot(int _round)
+        {
+            return (1 << (ROUNDS - 1 - _round)) - 1;
+        }
+
+    private:
+        std::array<node, N - 1> slots;      // Heap-ordered nodes, slots[0] is the final
+        std::array<int, N>      seed_slots; // Slot each team_id has advanced furthest to
+        team_id                 champion;   // Winner of the final
+
+        void build_seed_index();
+};
+
+
+/**
+ * @brief calls a function with the number of teams as a compile time constant
+ *        if it is one of the sizes brackets usually come in
+ *
+ * @param _teams is the number of teams
+ * @param _f is called with std::integral_constant<int, _teams>
+ * @return true if _f was called, false if _teams has no fixed size
+ */
+template <class F>
+bool with_fixed_size(int _teams, F && _f)
+{
+    switch (_teams)
+    {
+        case 8:  _f(std::integral_constant<int, 8>());  return true;
+        case 16: _f(std::integral_constant<int, 16>()); return true;
+        case 32: _f(std::integral_constant<int, 32>()); return true;
+        case 64: _f(std::integral_constant<int, 64>()); return true;
+    }
+    return false;
+}
+
+
+/**
+ * @brief Default constructor that lays out the first round in standard seeding
+ *        (team ids are seed - 1), the way init_bracket() seeds N teams, with no
+ *        games decided.
+ */
+template <int N>
+fixed_bracket<N>::fixed_bracket() : champion(NO_TEAM)
+{
+    for (int i = 0; i < N / 2; ++i)
+        slots[N / 2 - 1 + i].set_pair(SEEDS[2*i] - 1, SEEDS[2*i + 1] - 1);
+    build_seed_index();
+}
+
+
+/**
+ * @brief Param. constructor that copies the games of a bracket
+ *
+ * @param _source is a bracket of N teams
+ * @throws invalid_argument if the bracket has a different number of teams
+ */
+template <int N>
+fixed_bracket<N>::fixed_bracket(const bracket & _source) : champion(_source.get_champion())
+{
+    if (_source.num_teams() != N)
+        throw std::invalid_argument("Brackets are different sizes.");
+    for (int i = 0; i < SPOTS; ++i)
+        slots[i] = _source.get_slot(i);
+    for (int i = 0; i < N; ++i)
+        seed_slots[i] = _source.team_slot(i);
+}
+
+
+/**
+ * @brief puts the games into a bracket, which can then be saved or drawn
+ *
+ * @param _target is a bracket of N teams with the same first round
+ * @throws invalid_argument if the bracket has a different size or seeding
+ */
+template <int N>
+void fixed_bracket<N>::store(bracket & _target) const
+{
+    if (_target.num_teams() != N)
+        throw std::invalid_argument("Brackets are different sizes.");
+    for (int i = N / 2 - 1; i < SPOTS; ++i)
+        if (_target.get_slot(i).get_pair() != slots[i].get_pair())
+            throw std::invalid_argument("Brackets have different seeding.");
+    _target.set_picks(get_picks());
+}
+
+
+/**
+ * @brief advances a team one round by its seed, the same as
+ *        bracket::advance_team(). Will not advance the team if...
+ *        (1) the seed does not exist
+ *        (2) the seed was out of the running
+ *        (3) the seed currently has no matchup
+ *
+ * @param _seed is the seed of the team to advance
+ * @return true if the team has been advanced (or has no matchup yet)
+ * @return false if the team has not been found or cannot be advanced
+ */
+template <int N>
+bool fixed_bracket<N>::advance_team(int _seed)
+{
+    if (_seed < 1 || _seed > N || seed_slots[_seed - 1] < 0)
+        return false;
+
+    team_id id   = _seed - 1;
+    int     slot = seed_slots[id];
+    const std::pair<team_id, team_id> & spot = slots[slot].get_pair();
+
+    // Team is out of the running if its game already has a winner
+    if (winner(slot) != NO_TEAM)
+        return winner(slot) == id && slot == 0;
+
+    // Team has no matchup yet
+    if (spot.first == NO_TEAM || spot.second == NO_TEAM)
+        return true;
+
+    if (slot == 0)
+        champion = id;
+    else
+    {
+        int target = (slot - 1) / 2;
+        if (slot % 2)
+            slots[target].set_pair_first(id);
+        else
+            slots[target].set_pair_second(id);
+        seed_slots[id] = target;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Returns the winner of a game, which sits in the parent slot on the
+ *        side the game feeds (or is the champion for the final).
+ *
+ * @param _slot is the slot of the game
+ * @return team_id: the winner, or NO_TEAM if the game isn't decided
+ */
+template <int N>
+team_id fixed_bracket<N>::winner(int _slot) const
+{
+    if (_slot == 0)
+        return champion;
+
+    const std::pair<team_id, team_id> & next = slots[(_slot - 1) / 2].get_pair();
+    return _slot % 2 ? next.first : next.second;
+}
+
+
+/**
+ * @brief Returns the slot a team has advanced furthest to.
+ *
+ * @param _id is the id of the team
+ * @return int: the slot, or -1 if the team isn't in the bracket
+ */
+template <int N>
+int fixed_bracket<N>::team_slot(team_id _id) const
+{
+    return _id < (team_id)N ? seed_slots[_id] : -1;
+}
+
+
+/**
+ * @brief packs the winner of every game into one bit per game
+ *
+ * @return bracket_picks: the picks of the bracket
+ */
+template <int N>
+bracket_picks fixed_bracket<N>::get_picks() const
+{
+    bracket_picks picks(N);     // Picks of every game
+
+    for (int i = 0; i < SPOTS; ++i)
+        if (winner(i) != NO_TEAM)
+            picks.set_winner(i, winner(i) == slots[i].get_pair().second);
+    return picks;
+}
+
+
+/**
+ * @brief replaces every game after the first round with the winners in the
+ *        picks, keeping the first round
+ *
+ * @param _picks is the winner of every decided game
+ * @throws invalid_argument if the picks are for a different size of bracket,
+ *         or pick a winner for a game that can't have its matchup yet
+ */
+template <int N>
+void fixed_bracket<N>::set_picks(const bracket_picks & _picks)
+{
+    if (_picks.num_teams() != N)
+        throw std::invalid_argument("Picks are for different sized brackets.");
+
+    // A game can only be decided once both games feeding it are
+    for (int i = 0; i < SPOTS; ++i)
+    {
+        if (!_picks.is_decided(i))
+            continue;
+        if (i >= SPOTS / 2)
+        {
+            const std::pair<team_id, team_id> & spot = slots[i].get_pair();
+            if (spot.first == NO_TEAM || spot.second == NO_TEAM)
+                throw std::invalid_argument("Picks decide a game without a matchup.");
+        }
+        else if (!_picks.is_decided(2*i + 1) || !_picks.is_decided(2*i + 2))
+            throw std::invalid_argument("Picks decide a game without a matchup.");
+    }
+
+    for (int i = 0; i < SPOTS / 2; ++i)
+        slots[i].set_pair(NO_TEAM, NO_TEAM);
+    champion = NO_TEAM;
+
+    // Play the games from the first round up to the final
+    for (int i = SPOTS - 1; i >= 0; --i)
+    {
+        if (!_picks.is_decided(i))
+            continue;
+        const std::pair<team_id, team_id> & spot = slots[i].get_pair();
+        team_id won = _picks.second_won(i) ? spot.second : spot.first;
+
+        if (i == 0)
+            champion = won;
+        else if (i % 2)
+            slots[(i - 1) / 2].set_pair_first(won);
+        else
+            slots[(i - 1) / 2].set_pair_second(won);
+    }
+    build_seed_index();
+}
+
+
+/**
+ * @brief private helper that rebuilds the seed index from the first round up,
+ *        so the last slot recorded for a team is its furthest one
+ */
+template <int N>
+void fixed_bracket<N>::build_seed_index()
+{
+    seed_slots.fill(-1);
+    for (int i = SPOTS - 1; i >= 0; --i)
+    {
+        const std::pair<team_id, team_id> & spot = slots[i].get_pair();
+        if (spot.first != NO_TEAM)
+            seed_slots[spot.first] = i;
+        if (spot.second != NO_TEAM)
+            seed_slots[spot.second] = i;
+    }
+}
+
+#endif
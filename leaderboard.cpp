@@ -0,0 +1,180 @@
+/**
+ * @file leaderboard.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the leaderboard class which ranks
+ *        entries with bucket counts of the scores they hold.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "leaderboard.h"
+using namespace std;
+
+// Default constructor
+leaderboard::leaderboard() : max_score(0)
+{}
+
+
+/**
+ * @brief ranks every entry from scratch in O(entries log entries)
+ *
+ * @param _scores is the score of each entry, taken over by the leaderboard
+ * @param _max_score is the highest score an entry can reach
+ * @throws invalid_argument if a score is outside 0 to _max_score
+ */
+void leaderboard::reset(vector<int> && _scores, int _max_score)
+{
+    scores    = move(_scores);
+    max_score = _max_score;
+    levels.clear();
+    for (int e = 0; e < (int)scores.size(); ++e)
+    {
+        if (scores[e] < 0 || scores[e] > max_score)
+            throw invalid_argument("Score is out of range.");
+        levels.push_back(scores[e]);
+    }
+    sort(levels.begin(), levels.end());
+    levels.erase(unique(levels.begin(), levels.end()), levels.end());
+
+    counts.assign(levels.size(), 0);
+    for (int e = 0; e < (int)scores.size(); ++e)
+        ++counts[level(scores[e])];
+    count_above();
+}
+
+
+/**
+ * @brief adds points to every entry of a batch. The scores the batch moves to
+ *        are merged into the levels first, then the entries are moved, and the
+ *        entries above each level are recounted once for the whole batch.
+ *
+ * @param _entries is the entries to add points to
+ * @param _points is the points to add to each entry
+ * @throws invalid_argument if an entry would go past the max score
+ */
+void leaderboard::add(const vector<int> & _entries, int _points)
+{
+    vector<int> added;      // Scores the batch moves to, ascending
+    vector<int> merged;     // Levels with the added scores
+    vector<int> moved;      // Counts of the merged levels
+
+    if (_entries.empty() || _points == 0)
+        return;
+
+    for (int e : _entries)
+    {
+        long long moved_to = (long long)scores[e] + _points;
+        if (moved_to < 0 || moved_to > max_score)
+            throw invalid_argument("Score is out of range.");
+        added.push_back((int)moved_to);
+    }
+    sort(added.begin(), added.end());
+    added.erase(unique(added.begin(), added.end()), added.end());
+    set_union(levels.begin(), levels.end(), added.begin(), added.end(),
+        back_inserter(merged));
+
+    // Old levels are a subsequence of the merged ones
+    moved.assign(merged.size(), 0);
+    for (int l = 0, m = 0; l < (int)levels.size(); ++l, ++m)
+    {
+        while (merged[m] != levels[l])
+            ++m;
+        moved[m] = counts[l];
+    }
+    levels = move(merged);
+    counts = move(moved);
+
+    for (int e : _entries)
+    {
+        --counts[level(scores[e])];
+        scores[e] += _points;
+        ++counts[level(scores[e])];
+    }
+    count_above();
+}
+
+
+int leaderboard::score(int _entry) const { return scores[_entry]; }
+int leaderboard::rank(int _entry) const { return above[level(scores[_entry])] + 1; }
+int leaderboard::size() const { return scores.size(); }
+
+
+/**
+ * @brief lists the best entries. The lowest score that makes the top _k comes
+ *        from the bucket counts, then one pass over the entries picks out the
+ *        ones above it and, in entry order, as many tied at it as still fit.
+ *
+ * @param _k is the most entries to list
+ * @param _entries is filled with the entries, best first
+ */
+void leaderboard::top(int _k, vector<int> & _entries) const
+{
+    int cutoff;     // Lowest score in the top _k
+    int ties;       // Entries at the cutoff that fit
+    int l;          // Level of the cutoff
+
+    _entries.clear();
+    _k = min(_k, size());
+    if (_k <= 0)
+        return;
+
+    l = levels.size() - 1;
+    while (above[l] + counts[l] < _k)
+        --l;
+    cutoff = levels[l];
+    ties   = _k - above[l];
+
+    for (int e = 0; e < size(); ++e)
+    {
+        if (scores[e] > cutoff)
+            _entries.push_back(e);
+        else if (scores[e] == cutoff && ties > 0)
+        {
+            _entries.push_back(e);
+            --ties;
+        }
+    }
+
+    // Best first, entries were added in entry order so ties stay that way
+    stable_sort(_entries.begin(), _entries.end(), [this](int _a, int _b) {
+        return scores[_a] > scores[_b];
+    });
+}
+
+
+/**
+ * @brief private helper that finds the level of a score some entry holds
+ *
+ * @param _score is the score
+ * @return int: the index of the score in the levels
+ */
+int leaderboard::level(int _score) const
+{
+    return lower_bound(levels.begin(), levels.end(), _score) - levels.begin();
+}
+
+
+/**
+ * @brief private helper that drops the levels no entry holds any more and
+ *        counts, for each level left, the entries with a higher score
+ */
+void leaderboard::count_above()
+{
+    int kept = 0;   // Levels still held
+
+    for (int l = 0; l < (int)levels.size(); ++l)
+        if (counts[l] > 0)
+        {
+            levels[kept] = levels[l];
+            counts[kept] = counts[l];
+            ++kept;
+        }
+    levels.resize(kept);
+    counts.resize(kept);
+
+    above.resize(kept);
+    for (int l = kept - 1, total = 0; l >= 0; --l)
+    {
+        above[l] = total;
+        total += counts[l];
+    }
+}
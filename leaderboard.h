@@ -0,0 +1,56 @@
+/**
+ * @file leaderboard.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the leaderboard class which keeps entries
+ *        ranked by score as their scores change.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef LEADERBOARD
+#define LEADERBOARD
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <iterator>
+
+/**
+ * @brief Ranks entries by an integer score from 0 to a max score. Instead of
+ *        keeping the entries sorted, it keeps a bucket count of the entries at
+ *        each score some entry has, in score order, and for each of those
+ *        scores how many entries are above it. The buckets only cover scores
+ *        that are held, so there are never more than there are entries however
+ *        high the max score is. That makes a rank one binary search over the
+ *        buckets, and adding points to a batch of entries is O(batch log batch
+ *        + buckets) no matter how the batch reorders them. top() finds the
+ *        score the k-th entry has from the buckets and only has to pick out
+ *        the entries at or above it. Tied entries share a rank (1 + entries
+ *        with a higher score), and are listed in entry order.
+ */
+class leaderboard
+{
+    public:
+        leaderboard();              // Default constructor
+
+        // Rank every entry from scratch, _scores[e] is the score of entry e
+        void reset(std::vector<int> && _scores, int _max_score);
+        // Add the same points to each entry of a batch
+        void add(const std::vector<int> & _entries, int _points);
+        int  score(int _entry) const;   // Score of an entry
+        int  rank(int _entry) const;    // Rank of an entry, from 1
+        // The best _k entries, best first and ties by entry order
+        void top(int _k, std::vector<int> & _entries) const;
+        int  size() const;              // Number of entries ranked
+
+    private:
+        int              max_score;     // Highest score an entry can reach
+        std::vector<int> scores;        // Score of each entry
+        std::vector<int> levels;        // Each score held by an entry, ascending
+        std::vector<int> counts;        // Entries at each level
+        std::vector<int> above;         // Entries above each level
+
+        int  level(int _score) const;
+        void count_above();
+};
+
+#endif
@@ -12,15 +12,22 @@
  * @copyright Copyright (c) 2022
  */
 #include "bracket_driver.h"
+#include "archive_store.h"
 using namespace std;
 
-// MAIN
-int main()
+// MAIN, "--archive FILE" keeps saved brackets in one archive file instead of
+// resources/saved
+int main(int argc, char ** argv)
 {
-    bracket_driver user_bracket;
-
     try {
-        user_bracket.start();
+        unique_ptr<bracket_driver> user_bracket;
+
+        if (argc == 3 && string(argv[1]) == "--archive")
+            user_bracket.reset(new bracket_driver(
+                unique_ptr<bracket_store>(new archive_store(argv[2]))));
+        else
+            user_bracket.reset(new bracket_driver());
+        user_bracket->start();
     }  
     catch (const invalid_argument & err) {
         cerr << err.what() << endl;
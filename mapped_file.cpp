@@ -0,0 +1,99 @@
+/**
+ * @file mapped_file.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the mapped_file class which maps files
+ *        into memory on Windows and POSIX systems.
+ * 
+ * @copyright Copyright (c) 2022
+ */
+#include "mapped_file.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+/**
+ * @brief Param. constructor that opens and maps the whole file.
+ * 
+ * @param _file_name is the path of the file to map
+ * @throws invalid_argument if the file does not exist or can't be mapped
+ */
+mapped_file::mapped_file(const string & _file_name)
+    : bytes(nullptr), length(0), handle(nullptr)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(_file_name.c_str(), GENERIC_READ, FILE_SHARE_READ,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER file_size;
+
+    if (file == INVALID_HANDLE_VALUE)
+        throw invalid_argument("ERROR: file does not exist");
+    if (!GetFileSizeEx(file, &file_size))
+    {
+        CloseHandle(file);
+        throw invalid_argument("ERROR: file could not be read");
+    }
+    length = (size_t)file_size.QuadPart;
+
+    if (length > 0)
+    {
+        handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (handle)
+            bytes = (const char *)MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+    }
+    CloseHandle(file);
+    if (length > 0 && !bytes)
+    {
+        if (handle)
+            CloseHandle(handle);
+        throw invalid_argument("ERROR: file could not be read");
+    }
+#else
+    int         file = open(_file_name.c_str(), O_RDONLY);
+    struct stat file_info;
+
+    if (file < 0)
+        throw invalid_argument("ERROR: file does not exist");
+    if (fstat(file, &file_info) != 0)
+    {
+        close(file);
+        throw invalid_argument("ERROR: file could not be read");
+    }
+    length = (size_t)file_info.st_size;
+
+    if (length > 0)
+    {
+        void * mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapped != MAP_FAILED)
+            bytes = (const char *)mapped;
+    }
+    close(file);
+    if (length > 0 && !bytes)
+        throw invalid_argument("ERROR: file could not be read");
+#endif
+}
+
+
+// Destructor
+mapped_file::~mapped_file()
+{
+#ifdef _WIN32
+    if (bytes)
+        UnmapViewOfFile(bytes);
+    if (handle)
+        CloseHandle(handle);
+#else
+    if (bytes)
+        munmap((void *)bytes, length);
+#endif
+}
+
+
+// Getters
+const char * mapped_file::data() const { return bytes; }
+size_t mapped_file::size() const       { return length; }
@@ -0,0 +1,40 @@
+/**
+ * @file mapped_file.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the mapped_file class which maps a whole file
+ *        into memory for reading.
+ * 
+ * @copyright Copyright (c) 2022
+ */
+#ifndef MAPPED_FILE
+#define MAPPED_FILE
+
+#include <string>
+#include <stdexcept>
+#include <cstddef>
+
+/**
+ * @brief Maps a file into memory read-only for as long as the object lives, so
+ *        it can be read as one buffer without copying through a stream. Uses
+ *        mmap on POSIX systems and a file mapping on Windows. An empty file
+ *        gives a null buffer of size 0.
+ */
+class mapped_file
+{
+    public:
+        mapped_file(const std::string & _file_name);    // Param. constructor
+        mapped_file(const mapped_file &) = delete;
+        ~mapped_file();                                 // Destructor
+
+        mapped_file & operator = (const mapped_file &) = delete;
+
+        const char * data() const;      // Start of the file's bytes
+        std::size_t  size() const;      // Number of bytes in the file
+
+    private:
+        const char * bytes;     // Mapped bytes of the file
+        std::size_t  length;    // Length of the file
+        void *       handle;    // File mapping handle (Windows only)
+};
+
+#endif
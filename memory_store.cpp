@@ -0,0 +1,82 @@
+/**
+ * @file memory_store.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the memory_store class, a bracket store
+ *        held in memory.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "memory_store.h"
+using namespace std;
+
+/**
+ * @brief gets the names of every bracket, sorted
+ *
+ * @param _names is a std::vector<std::string> to fill (must be empty)
+ * @throws invalid_argument if the vector isn't empty or there are no brackets
+ */
+void memory_store::get_files(vector<string> & _names)
+{
+    if (_names.size() > 0)
+        throw invalid_argument("Vector argument is non-empty");
+    if (saves.empty())
+        throw invalid_argument("No brackets saved yet.");
+    for (const auto & saved : saves)
+        _names.push_back(saved.first);
+}
+
+
+bool memory_store::contains(const string & _name)
+{
+    return saves.count(_name) > 0;
+}
+
+
+// Teams in a bracket, read from the header of its save
+int memory_store::num_teams(const string & _name)
+{
+    auto         found = saves.find(_name);
+    saved_header header;
+
+    if (found == saves.end() || found->second.size() < sizeof(header))
+        return 0;
+    memcpy(&header, found->second.data(), sizeof(header));
+    return header.num_teams;
+}
+
+
+/**
+ * @brief loads a bracket from its save
+ *
+ * @param _name is the name of the bracket
+ * @param _target is the bracket to load into
+ * @throws invalid_argument if there is no such bracket
+ */
+void memory_store::load(const string & _name, bracket & _target)
+{
+    auto found = saves.find(_name);
+
+    if (found == saves.end())
+        throw invalid_argument("ERROR: file does not exist");
+    _target.fill_bracket(found->second.data(), found->second.size());
+    _target.mark_saved();
+}
+
+
+/**
+ * @brief saves a bracket, replacing any bracket of the same name
+ *
+ * @param _name is the name of the bracket
+ * @param _source is the bracket to save
+ */
+void memory_store::save(const string & _name, bracket & _source)
+{
+    _source.write_binary(saves[_name]);
+    _source.mark_saved();
+}
+
+
+bool memory_store::remove(const string & _name)
+{
+    return saves.erase(_name) > 0;
+}
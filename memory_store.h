@@ -0,0 +1,38 @@
+/**
+ * @file memory_store.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the memory_store class, a bracket store held
+ *        in memory.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef MEMORY_STORE
+#define MEMORY_STORE
+
+#include <string>
+#include <vector>
+#include <map>
+#include "bracket_store.h"
+
+/**
+ * @brief Keeps brackets in memory, each as the bytes of its binary save (see
+ *        saved_format.h), sorted by name. Nothing touches the disk, so tests
+ *        and benchmarks can use it to time or check the rest of the program
+ *        without the file system (bench/bracket_bench.cpp times it against
+ *        the archive store). Everything is lost when it is destroyed.
+ */
+class memory_store : public bracket_store
+{
+    public:
+        void get_files(std::vector<std::string> & _names) override;
+        bool contains(const std::string & _name) override;
+        int  num_teams(const std::string & _name) override;
+        void load(const std::string & _name, bracket & _target) override;
+        void save(const std::string & _name, bracket & _source) override;
+        bool remove(const std::string & _name) override;
+
+    private:
+        std::map<std::string, std::string> saves;  // Save of each bracket
+};
+
+#endif
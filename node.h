@@ -9,38 +9,32 @@
 #ifndef BRACKET_NODE
 #define BRACKET_NODE
 
+#include <utility>
 #include "team.h"
 
 /**
- * @brief The node class is a node in a complete balanced BST for a tournament
- *        bracket. You can set left and right pointers as well as the data in 
- *        the pair of team, as well as get all of the data. (A glorified struct)
+ * @brief The node class is one slot in the implicit, array-backed bracket tree.
+ *        Nodes hold no child pointers; the bracket stores every node in one
+ *        heap-ordered array, so a node's children live at 2i+1 and 2i+2 and
+ *        its parent at (i-1)/2. A node only holds the ids of its two teams in
+ *        the bracket's team table, with NO_TEAM for an empty spot, so it stays
+ *        a few bytes and copies as plain memory. You can set and get the pair
+ *        of team ids in the slot. (A glorified struct)
  */
 class node
 {
     public:
         node();                                 // Default constructor
-        node(const node &);                     // Copy constructor
-        node(const std::pair<team, team> &);    // Param. constructor
+        node(const std::pair<team_id, team_id> &);  // Param. constructor
 
-        node & operator = (const node &);       // Copy assignment operator
+        void set_pair(team_id, team_id);        // Set both teams
+        void set_pair_first(team_id);           // Set first team
+        void set_pair_second(team_id);          // Set second team
 
-        void set_left(node *);                  // Set left pointer
-        void set_right(node *);                 // Set right pointer
-        void set_pair(const team &, const team &);  // Set both teams
-        void set_pair_first(const team &);      // Set first team
-        void set_pair_second(const team &);     // Set second team
-
-        node *& get_left();                     // Get left pointer
-        node *& get_right();                    // Get right pointer
-        const std::pair<team, team> & get_pair() const; // Get both teams
+        const std::pair<team_id, team_id> & get_pair() const; // Get both teams
 
     private:
-        std::pair<team, team> spot;     // Playoff round contenders
-        node *                left;     // Left child
-        node *                right;    // Right child
-
-        void copy_node(const node &);           // Copy helper
+        std::pair<team_id, team_id> spot;   // Playoff round contenders
 };
 
-#endif
\ No newline at end of file
+#endif
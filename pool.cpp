@@ -0,0 +1,505 @@
+/**
+ * @file pool.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the pool class which scores bracket
+ *        entries from their packed picks.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "pool.h"
+using namespace std;
+
+/**
+ * @brief Param. constructor that sets up the results every entry is scored
+ *        against and the points for each round.
+ *
+ * @param _actual is the bracket of actual results
+ * @param _points is the points for a correct game in each round, from the
+ *        first round to the final (empty for 1, 2, 4, ...)
+ * @throws invalid_argument if there isn't one point value per round, a value
+ *         is negative, or a perfect score wouldn't fit in an int
+ */
+pool::pool(const bracket & _actual, const vector<int> & _points)
+    : rounds(_actual.num_rounds()), words((_actual.num_teams() - 1 + 63) / 64),
+      points(_points)
+{
+    long long perfect = 0;  // Score of a perfect bracket
+
+    if (points.empty())
+        for (int r = 0; r < rounds; ++r)
+            points.push_back(1 << r);
+    if ((int)points.size() != rounds)
+        throw invalid_argument("Need one point value for each round.");
+    for (int r = 0; r < rounds; ++r)
+    {
+        if (points[r] < 0)
+            throw invalid_argument("Point values can't be negative.");
+        perfect += (long long)points[r] * ((_actual.num_teams() / 2) >> r);
+    }
+    if (perfect > INT_MAX)
+        throw invalid_argument("Point values are too large.");
+
+    // Games of round r are slots [2^(rounds-1-r) - 1, 2^(rounds-r) - 1)
+    round_masks.assign(rounds * words, 0);
+    game_points.resize(_actual.num_teams() - 1);
+    for (int r = 0; r < rounds; ++r)
+    {
+        int first = _actual.round_first_slot(r);
+        for (int g = first; g < 2 * first + 1; ++g)
+        {
+            round_masks[r * words + g / 64] |= 1ull << (g % 64);
+            game_points[g] = points[r];
+        }
+    }
+
+    for (int i = (_actual.num_teams() - 1) / 2; i < _actual.num_teams() - 1; ++i)
+        seeding.push_back(_actual.get_slot(i).get_pair());
+    set_actual(_actual);
+}
+
+
+/**
+ * @brief private helper that takes the picks of the actual results, and for
+ *        every decided game, which of its two games the winner came from.
+ *
+ * @param _actual is the bracket of actual results
+ * @throws invalid_argument if the results have a different seeding
+ */
+void pool::set_actual(const bracket & _actual)
+{
+    int games = _actual.num_teams() - 1;    // Games in bracket
+
+    if (!same_seeding(_actual))
+        throw invalid_argument("Results are for a different bracket.");
+
+    bracket_picks picks = _actual.get_picks();
+    actual_winners = picks.get_winners();
+    actual_decided = picks.get_decided();
+
+    path_child.assign(games, -1);
+    for (int g = 0; g < games / 2; ++g)
+        if (picks.is_decided(g))
+            path_child[g] = 2*g + 1 + picks.second_won(g);
+}
+
+
+/**
+ * @brief private helper that checks a bracket has the pool's first round
+ *
+ * @param _other is the bracket to check
+ * @return true if the bracket has the same teams in the same first round games
+ */
+bool pool::same_seeding(const bracket & _other) const
+{
+    if (_other.num_teams() != (int)seeding.size() * 2)
+        return false;
+    for (int i = 0; i < (int)seeding.size(); ++i)
+        if (_other.get_slot(seeding.size() - 1 + i).get_pair() != seeding[i])
+            return false;
+    return true;
+}
+
+
+/**
+ * @brief replaces the actual results, such as after a game is played, and
+ *        rescores every entry
+ *
+ * @param _actual is the bracket of actual results
+ * @param _threads is the number of threads to use (0 for every core)
+ */
+void pool::set_results(const bracket & _actual, int _threads)
+{
+    set_actual(_actual);
+    score(_threads);
+}
+
+
+/**
+ * @brief decides one more game of the actual results and rescores only that
+ *        game. An entry got the game right if it picked the same side and got
+ *        right the game the winner came from (so the entry has the same team
+ *        coming out of it). With the picks sliced by game, that is checked for
+ *        64 entries at a time, and only the entries that got it right are
+ *        visited to move them up the board.
+ *
+ * @param _game is the slot of the game
+ * @param _second_won is false if the first team won, true if the second did
+ * @param _threads is the number of threads to use if every entry has to be
+ *        rescored (0 for every core)
+ * @throws invalid_argument if the game doesn't exist, already has a different
+ *         result, or its matchup isn't decided yet
+ */
+void pool::apply_result(int _game, bool _second_won, int _threads)
+{
+    vector<int> changed;                // Entries that got the game right
+    uint64_t    bit    = 1ull << (_game % 64);
+    int         games  = path_child.size();
+    int         groups = (num_entries() + 63) / 64;
+
+    if (_game < 0 || _game >= (int)path_child.size())
+        throw invalid_argument("No such game in bracket.");
+    if (actual_decided[_game / 64] & bit)
+    {
+        if (((actual_winners[_game / 64] & bit) != 0) == _second_won)
+            return;
+        throw invalid_argument("Game already has a different result.");
+    }
+    if (_game < (int)path_child.size() / 2)
+    {
+        int left  = 2*_game + 1;    // Games feeding this one
+        int right = 2*_game + 2;
+        if (!((actual_decided[left / 64] >> (left % 64)) & 1) ||
+            !((actual_decided[right / 64] >> (right % 64)) & 1))
+            throw invalid_argument("Game doesn't have its matchup yet.");
+        path_child[_game] = 2*_game + 1 + _second_won;
+    }
+
+    actual_decided[_game / 64] |= bit;
+    if (_second_won)
+        actual_winners[_game / 64] |= bit;
+
+    // Entries added since the last score() have nothing to build on
+    if (board.size() != num_entries())
+    {
+        score(_threads);
+        return;
+    }
+
+    for (int w = 0; w < groups; ++w)
+    {
+        size_t   at   = (size_t)w * games;
+        uint64_t hits = slice_decided[at + _game] &
+            (_second_won ? slice_picks[at + _game] : ~slice_picks[at + _game]);
+
+        if (path_child[_game] >= 0)
+            hits &= slice_correct[at + path_child[_game]];
+        slice_correct[at + _game] |= hits;
+
+        // Lowest set bit each time round
+        for (; hits; hits &= hits - 1)
+            changed.push_back(w * 64 + popcount((hits & (~hits + 1)) - 1));
+    }
+    board.add(changed, game_points[_game]);
+}
+
+
+/**
+ * @brief takes the actual results after more games have been decided, such as
+ *        after bracket::advance_team(), and rescores only the new games. The
+ *        new games are applied from the first round up, so each one has its
+ *        matchup. If a game's result was changed or taken back, every entry
+ *        is rescored instead.
+ *
+ * @param _actual is the bracket of actual results
+ * @param _threads is the number of threads to use (0 for every core)
+ * @throws invalid_argument if the results have a different seeding
+ */
+void pool::apply_results(const bracket & _actual, int _threads)
+{
+    bracket_picks picks;    // Picks of the new results
+
+    if (!same_seeding(_actual))
+        throw invalid_argument("Results are for a different bracket.");
+    picks = _actual.get_picks();
+
+    for (int g = 0; g < picks.num_games(); ++g)
+    {
+        bool was_decided = (actual_decided[g / 64] >> (g % 64)) & 1;
+        bool was_second  = (actual_winners[g / 64] >> (g % 64)) & 1;
+        if (was_decided && (!picks.is_decided(g) || picks.second_won(g) != was_second))
+        {
+            set_results(_actual, _threads);
+            return;
+        }
+    }
+
+    for (int g = picks.num_games() - 1; g >= 0; --g)
+        if (picks.is_decided(g))
+            apply_result(g, picks.second_won(g), _threads);
+}
+
+
+/**
+ * @brief adds an entry to the pool from its bracket
+ *
+ * @param _name is the name to show for the entry
+ * @param _entry is the entry's bracket of picks
+ * @throws invalid_argument if the entry has a different seeding than the pool
+ */
+void pool::add_entry(const string & _name, const bracket & _entry)
+{
+    if (!same_seeding(_entry))
+        throw invalid_argument("Entry is for a different bracket.");
+    add_entry(_name, _entry.get_picks());
+}
+
+
+/**
+ * @brief adds an entry to the pool from its packed picks
+ *
+ * @param _name is the name to show for the entry
+ * @param _picks is the entry's picks, for the pool's seeding
+ * @throws invalid_argument if the picks are for a different size of bracket
+ */
+void pool::add_entry(const string & _name, const bracket_picks & _picks)
+{
+    if (_picks.num_teams() != (int)seeding.size() * 2)
+        throw invalid_argument("Entry is for a different bracket.");
+
+    int      games = _picks.num_games();    // Games in bracket
+    int      entry = names.size();          // Index of the new entry
+    size_t   at    = (size_t)(entry / 64) * games;
+    uint64_t bit   = 1ull << (entry % 64);  // Bit of the entry in its group
+
+    names.push_back(_name);
+    entry_picks.insert(entry_picks.end(), _picks.get_winners().begin(),
+        _picks.get_winners().end());
+    entry_picks.insert(entry_picks.end(), _picks.get_decided().begin(),
+        _picks.get_decided().end());
+
+    // Start a new group of 64 entries
+    if (entry % 64 == 0)
+    {
+        slice_picks.resize(at + games, 0);
+        slice_decided.resize(at + games, 0);
+        slice_correct.resize(at + games, 0);
+    }
+    for (int g = 0; g < games; ++g)
+    {
+        if (!_picks.is_decided(g))
+            continue;
+        slice_decided[at + g] |= bit;
+        if (_picks.second_won(g))
+            slice_picks[at + g] |= bit;
+    }
+}
+
+
+/**
+ * @brief scores every entry against the actual results and ranks them.
+ *        Entries are split evenly over the threads.
+ *
+ * @param _threads is the number of threads to use (0 for every core)
+ */
+void pool::score(int _threads)
+{
+    vector<thread> workers;     // Threads scoring entries
+    vector<int>    scores;      // Score of each entry
+    int            entries = num_entries();
+    int            groups  = (entries + 63) / 64;
+
+    // Threads take whole groups of 64 entries, so they never share a word
+    _threads = num_threads(_threads);
+    scores.assign(entries, 0);
+    fill(slice_correct.begin(), slice_correct.end(), 0);
+    for (int t = 0, first = 0; t < _threads; ++t)
+    {
+        int share = min(entries - first,
+            64 * (groups / _threads + (t < groups % _threads)));
+        workers.push_back(thread(&pool::score_range, this, first, first + share,
+            ref(scores)));
+        first += share;
+    }
+    for (int t = 0; t < _threads; ++t)
+        workers[t].join();
+
+    board.reset(move(scores), max_score());
+}
+
+
+/**
+ * @brief private helper that picks how many threads to split the entries
+ *        over, so small pools aren't split at all
+ *
+ * @param _threads is the number of threads asked for (0 for every core)
+ * @return int: the number of threads to use
+ */
+int pool::num_threads(int _threads) const
+{
+    if (_threads < 1)
+        _threads = max(1u, thread::hardware_concurrency());
+    return max(1, min(_threads, num_entries() / 4096));
+}
+
+
+/**
+ * @brief private helper that scores a range of entries on one thread
+ *
+ * @param _first is the first entry to score
+ * @param _last is one past the last entry to score
+ * @param _scores is filled in with the score of each entry in the range
+ */
+void pool::score_range(int _first, int _last, vector<int> & _scores)
+{
+    vector<uint64_t> correct(words);    // Games the entry got right
+
+    if (with_fixed_size(seeding.size() * 2, [&](auto _teams) {
+            score_range_fixed<decltype(_teams)::value>(_first, _last, _scores);
+        }))
+        return;
+
+    for (int e = _first; e < _last; ++e)
+        _scores[e] = score_entry(e, correct);
+}
+
+
+/**
+ * @brief private helper that scores one entry. A pick for a game is wrong if
+ *        it differs from the result or is missing, and a pick is also wrong if
+ *        the pick for the game the actual winner came from is wrong, since the
+ *        entry has some other team coming out of that game.
+ *
+ * The games the entry got right are kept in the slices for apply_result().
+ *
+ * @param _entry is the entry to score
+ * @param _correct is scratch space of one bitset
+ * @return int: the entry's score
+ */
+int pool::score_entry(int _entry, vector<uint64_t> & _correct)
+{
+    const uint64_t * winners = &entry_picks[(size_t)_entry * 2 * words];
+    const uint64_t * decided = winners + words;
+    uint64_t *       correct = _correct.data();
+    int              games   = path_child.size();
+    size_t           at      = (size_t)(_entry / 64) * games;
+    int              score   = 0;
+
+    // Start with the wrong picks, and flip to the right ones after
+    for (int w = 0; w < words; ++w)
+        correct[w] = ((winners[w] ^ actual_winners[w]) | ~decided[w]) &
+            actual_decided[w];
+
+    // Children are later slots than their parent, so they're done first
+    for (int g = (int)path_child.size() / 2 - 1; g >= 0; --g)
+    {
+        int c = path_child[g];
+        if (c >= 0 && (correct[c / 64] >> (c % 64)) & 1)
+            correct[g / 64] |= 1ull << (g % 64);
+    }
+
+    for (int w = 0; w < words; ++w)
+        correct[w] = actual_decided[w] & ~correct[w];
+    for (int r = 0; r < rounds; ++r)
+    {
+        int right = 0;
+        for (int w = 0; w < words; ++w)
+            right += popcount(correct[w] & round_masks[r * words + w]);
+        score += right * points[r];
+    }
+
+    for (int w = 0; w < words; ++w)
+        for (uint64_t bits = correct[w]; bits; bits &= bits - 1)
+            slice_correct[at + w * 64 + popcount((bits & (~bits + 1)) - 1)] |=
+                1ull << (_entry % 64);
+    return score;
+}
+
+
+/**
+ * @brief private helper that scores a range of entries on one thread, for a
+ *        pool of N teams. Scores the same way as score_entry(), but every
+ *        bitset is one word held in a register, and the path of the actual
+ *        winners, the round masks and the points are copied into arrays on the
+ *        stack with constant bounds.
+ *
+ * @param _first is the first entry to score
+ * @param _last is one past the last entry to score
+ * @param _scores is filled in with the score of each entry in the range
+ */
+template <int N>
+void pool::score_range_fixed(int _first, int _last, vector<int> & _scores)
+{
+    using games = fixed_bracket<N>;
+    static_assert(games::SPOTS <= 64, "Picks of a fixed pool must fit in one word.");
+
+    const uint64_t               won  = actual_winners[0];  // Results
+    const uint64_t               done = actual_decided[0];
+    array<int, games::SPOTS / 2> child;                     // See path_child
+    array<uint64_t, games::ROUNDS> masks;                   // See round_masks
+    array<int, games::ROUNDS>    round_points;
+
+    copy(path_child.begin(), path_child.begin() + games::SPOTS / 2, child.begin());
+    copy(round_masks.begin(), round_masks.end(), masks.begin());
+    copy(points.begin(), points.end(), round_points.begin());
+
+    for (int e = _first; e < _last; ++e)
+    {
+        uint64_t winners = entry_picks[2 * (size_t)e];
+        uint64_t decided = entry_picks[2 * (size_t)e + 1];
+        uint64_t wrong   = ((winners ^ won) | ~decided) & done;
+        size_t   at      = (size_t)(e / 64) * games::SPOTS;
+        int      score   = 0;
+
+        // Children are later slots than their parent, so they're done first
+        for (int g = games::SPOTS / 2 - 1; g >= 0; --g)
+            if (child[g] >= 0)
+                wrong |= ((wrong >> child[g]) & 1) << g;
+
+        uint64_t correct = done & ~wrong;
+        for (int r = 0; r < games::ROUNDS; ++r)
+            score += popcount(correct & masks[r]) * round_points[r];
+        _scores[e] = score;
+
+        for (uint64_t bits = correct; bits; bits &= bits - 1)
+            slice_correct[at + popcount((bits & (~bits + 1)) - 1)] |= 1ull << (e % 64);
+    }
+}
+
+
+int pool::num_entries() const { return names.size(); }
+const string & pool::get_name(int _entry) const { return names[_entry]; }
+int pool::get_score(int _entry) const { return board.score(_entry); }
+int pool::get_rank(int _entry) const { return board.rank(_entry); }
+
+
+/**
+ * @brief lists the best entries in the pool
+ *
+ * @param _k is the most entries to list
+ * @param _entries is filled with the entries, best first and ties by entry order
+ */
+void pool::top(int _k, vector<int> & _entries) const
+{
+    board.top(_k, _entries);
+}
+
+
+/**
+ * @brief Returns the score of a bracket with every game picked correctly.
+ *
+ * @return int: the most points an entry can score
+ */
+int pool::max_score() const
+{
+    int perfect = 0;
+
+    for (int r = 0; r < rounds; ++r)
+        perfect += points[r] * ((int)seeding.size() >> r);
+    return perfect;
+}
+
+
+/**
+ * @brief prints the top of the leaderboard, with a rank, name and score for
+ *        each entry
+ *
+ * @param _top is the number of entries to print
+ */
+void pool::display(int _top) const
+{
+    ios_base::fmtflags flags = cout.flags();    // Format to restore after
+    vector<int>        best;                    // Entries to print
+
+    top(_top, best);
+    cout << left << setw(8) << setfill(' ') << "RANK"
+         << setw(SIZE_PAIR_PADDING * 2) << "ENTRY" << "SCORE" << endl
+         << setw(SIZE_PAIR_PADDING * 2 + 13) << setfill('=') << '=' << endl;
+    for (int i = 0; i < (int)best.size(); ++i)
+    {
+        int e = best[i];
+        cout << left << setfill(' ') << setw(8) << get_rank(e)
+             << setw(SIZE_PAIR_PADDING * 2) << names[e].substr(0, SIZE_PAIR_PADDING * 2 - 1)
+             << get_score(e) << " / " << max_score() << endl;
+    }
+    cout.flags(flags);
+}
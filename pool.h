@@ -0,0 +1,97 @@
+/**
+ * @file pool.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the pool class which scores a pool of bracket
+ *        entries against the actual results and ranks them.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef POOL
+#define POOL
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <climits>
+#include "bracket.h"
+#include "fixed_bracket.h"
+#include "bracket_picks.h"
+#include "leaderboard.h"
+
+/**
+ * @brief A pool of entries, each a bracket of picks for the same seeding, that
+ *        are scored against one bracket of actual results. An entry earns the
+ *        points of a round for every game of that round where the team it
+ *        picked to win is the team that actually won. Entries only keep their
+ *        packed picks (see bracket_picks.h), so an entry is scored with a few
+ *        word operations: the picks that differ from the results are XORed
+ *        out, a wrong pick is carried up the path the actual winner took, and
+ *        the correct games of each round are counted with popcount. Entries
+ *        are scored over every core. The picks are also kept sliced by game,
+ *        64 entries to a word, along with which games each entry got right.
+ *        When one more game is decided, apply_result() checks it for 64
+ *        entries at a time and moves the entries that got it right up the
+ *        leaderboard (see leaderboard.h), without rescoring anyone. Pools of a
+ *        common size are scored with the size built in (see fixed_bracket.h),
+ *        where every entry's picks fit in one word.
+ */
+class pool : protected utils
+{
+    public:
+        // Param. constructor, points are per round from the first round (empty
+        // for 1 point in the first round, doubling every round)
+        pool(const bracket & _actual, const std::vector<int> & _points = {});
+
+        // Replace the actual results (same seeding) and rescore
+        void set_results(const bracket & _actual, int _threads = 0);
+        // Decide one more game (false if the first team won) and rescore it
+        void apply_result(int _game, bool _second_won, int _threads = 0);
+        // Take the games decided since the last results, rescoring only those
+        void apply_results(const bracket & _actual, int _threads = 0);
+        // Add an entry, it isn't scored until score() is called
+        void add_entry(const std::string & _name, const bracket & _entry);
+        void add_entry(const std::string & _name, const bracket_picks & _picks);
+        // Score and rank every entry (0 threads uses every core)
+        void score(int _threads = 0);
+        int  num_entries() const;               // Number of entries in pool
+        const std::string & get_name(int _entry) const; // Name of an entry
+        int  get_score(int _entry) const;       // Score of an entry
+        int  get_rank(int _entry) const;        // Rank of an entry, from 1
+        int  max_score() const;                 // Score of a perfect bracket
+        // The best _k entries, best first and ties by entry order
+        void top(int _k, std::vector<int> & _entries) const;
+        // Prints the top entries of the leaderboard
+        void display(int _top = 10) const;
+
+    protected:
+        int rounds;                             // Number of rounds of games
+        int words;                              // Words in each bitset
+        std::vector<int> points;                // Points for a game in each round
+        std::vector<std::pair<team_id, team_id>> seeding; // First round matchups
+        std::vector<std::uint64_t> actual_winners;  // Winner bits of results
+        std::vector<std::uint64_t> actual_decided;  // Games with a result
+        std::vector<int> path_child;            // Game the actual winner came from
+        std::vector<int> game_points;           // Points for each game
+        std::vector<std::uint64_t> round_masks; // [round * words + word]
+        std::vector<std::string> names;         // Name of each entry
+        std::vector<std::uint64_t> entry_picks; // Winner then decided bits of each
+        // Bits of 64 entries at a time for each game, [group * games + game]
+        std::vector<std::uint64_t> slice_picks;     // Entry picked second team
+        std::vector<std::uint64_t> slice_decided;   // Entry picked a winner
+        std::vector<std::uint64_t> slice_correct;   // Entry got game right
+        leaderboard      board;                 // Entries ranked by score
+
+    private:
+        void set_actual(const bracket & _actual);
+        bool same_seeding(const bracket & _other) const;
+        int  num_threads(int _threads) const;
+        void score_range(int _first, int _last, std::vector<int> & _scores);
+        template <int N>
+        void score_range_fixed(int _first, int _last, std::vector<int> & _scores);
+        int  score_entry(int _entry, std::vector<std::uint64_t> & _correct);
+};
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ * @file saved_format.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds the checks every reader of the binary saved bracket format
+ *        makes before reading a save.
+ * 
+ * @copyright Copyright (c) 2022
+ */
+#include "saved_format.h"
+#include "bracket.h"
+using namespace std;
+
+/**
+ * @brief checks that a buffer holds a whole binary save of a known version,
+ *        and finds where its tables start. Sizes are checked in 64 bits before
+ *        any pointer is made from them. The checksum isn't checked, that needs
+ *        every byte of the save to be read.
+ * 
+ * @param _bytes is the start of the save
+ * @param _size is the number of bytes in the save
+ * @param _tables is set to the header and the start of each table
+ * @throws invalid_argument if the save is the wrong version or size, or its
+ *         number of teams isn't a power of two a bracket can hold
+ */
+void read_saved_tables(const char * _bytes, size_t _size, saved_tables & _tables)
+{
+    saved_header & header = _tables.header;
+
+    if (_size < sizeof(header))
+        throw invalid_argument("Saved bracket is corrupt (file cut short)");
+    memcpy(&header, _bytes, sizeof(header));
+    if (memcmp(header.magic, SAVED_MAGIC, sizeof(SAVED_MAGIC)) != 0 ||
+        (header.version != 1 && header.version != SAVED_VERSION))
+        throw invalid_argument("Saved bracket is from an unknown version");
+    if (header.num_teams < 2 || header.num_teams > (uint32_t)MAX_TEAMS ||
+        (header.num_teams & (header.num_teams - 1)) != 0)
+        throw invalid_argument("Number of teams isn't power of two.");
+
+    if ((uint64_t)_size != sizeof(header) + (uint64_t)header.num_teams * sizeof(saved_team) +
+        (uint64_t)(header.num_teams - 1) * sizeof(saved_slot) + header.name_bytes)
+        throw invalid_argument("Saved bracket is corrupt (file cut short)");
+    _tables.teams = _bytes + sizeof(header);
+    _tables.slots = _tables.teams + (size_t)header.num_teams * sizeof(saved_team);
+    _tables.names = _tables.slots + (size_t)(header.num_teams - 1) * sizeof(saved_slot);
+}
@@ -0,0 +1,104 @@
+/**
+ * @file saved_format.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds the layout of the binary saved bracket format.
+ * 
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SAVED_FORMAT
+#define SAVED_FORMAT
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * LAYOUT (all fields fixed width, in the byte order of the machine that saved):
+ *   saved_header                       32 bytes
+ *   saved_team  x num_teams            24 bytes each, indexed by team_id
+ *   saved_slot  x (num_teams - 1)       8 bytes each, heap order (0 is final)
+ *   school names                       name_bytes, not null terminated
+ * The checksum is a 64-bit FNV-1a hash (utils::checksum()) of every byte after
+ * the header. A team with seed 0 is unused, and a slot side of SAVED_NO_TEAM is
+ * an empty spot. Version 1 saves have no champion (the field was reserved and
+ * always 0), and are still loaded.
+ *
+ * EDIT LOG (<save>.log next to the save, same byte order):
+ *   saved_log_header                   16 bytes
+ *   saved_log_edit  x any number       12 bytes each, oldest first
+ * Each edit is one spot written since the save, so replaying them in order over
+ * the save gives the bracket. The log only applies to the save whose checksum
+ * it holds, a log for any other save is stale and dropped. A record cut short
+ * by a crash at the end of the log is ignored.
+ *
+ * A save is loaded straight from a memory mapped file, and older text saves
+ * are read as they are and saved again in this format. bracket::save_changes()
+ * writes nothing if the bracket didn't change since it was loaded or saved,
+ * and otherwise appends the spots written to the edit log. Once the log grows
+ * to a quarter of the bracket (LOG_MIN_EDITS at least) it is folded back into
+ * the save on a background thread.
+ */
+static const char          SAVED_MAGIC[4]    = {'P', 'B', 'R', 'K'};
+static const char          SAVED_EXTENSION[] = ".pbrk";  // Extension of a save
+static const std::uint32_t SAVED_VERSION     = 2;
+static const std::uint32_t SAVED_NO_TEAM     = 0xFFFFFFFF;
+
+struct saved_header
+{
+    char          magic[4];     // SAVED_MAGIC
+    std::uint32_t version;      // SAVED_VERSION
+    std::uint32_t num_teams;    // Teams in the bracket (2^x)
+    std::uint32_t name_bytes;   // Size of the school names block
+    std::uint64_t checksum;     // Hash of everything after the header
+    std::uint32_t champion;     // Team id of winner of final (since version 2)
+    std::uint32_t reserved;     // Always 0
+};
+
+struct saved_team
+{
+    std::uint32_t name_offset;  // Start of name in the school names block
+    std::uint32_t name_length;  // Length of name
+    std::int32_t  wins;         // Wins for season
+    std::int32_t  losses;       // Losses for season
+    std::int32_t  ties;         // Ties for season
+    std::int32_t  seed;         // Seed in division (0 for unused)
+};
+
+struct saved_slot
+{
+    std::uint32_t first;        // Team id of first team
+    std::uint32_t second;       // Team id of second team
+};
+
+/**
+ * @brief The header of a binary save and where each of its tables starts, as
+ *        found by read_saved_tables()
+ */
+struct saved_tables
+{
+    saved_header header;        // Header of the save
+    const char * teams;         // Start of the team records
+    const char * slots;         // Start of the slot records
+    const char * names;         // Start of the school names
+};
+
+// Checks the header and size of a binary save and finds its tables
+void read_saved_tables(const char * _bytes, std::size_t _size, saved_tables & _tables);
+
+static const char          SAVED_LOG_MAGIC[4] = {'P', 'B', 'R', 'L'};
+static const std::uint32_t SAVED_LOG_VERSION  = 1;
+
+struct saved_log_header
+{
+    char          magic[4];     // SAVED_LOG_MAGIC
+    std::uint32_t version;      // SAVED_LOG_VERSION
+    std::uint64_t base;         // Checksum of the save the log applies to
+};
+
+struct saved_log_edit
+{
+    std::int32_t  slot;         // Slot written (-1 for the champion)
+    std::uint32_t second;       // 1 if the second spot was written
+    std::uint32_t team;         // Team id written (SAVED_NO_TEAM to clear)
+};
+
+#endif
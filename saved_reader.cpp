@@ -0,0 +1,253 @@
+/**
+ * @file saved_reader.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the saved_reader class which reads parts
+ *        of a saved bracket without loading the rest of it.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "saved_reader.h"
+using namespace std;
+
+/**
+ * @brief Param. constructor that maps the save and checks its header and size,
+ *        and reads its edit log. Nothing after the header is read. A text save
+ *        is parsed whole into memory and laid out in the binary format there,
+ *        the file itself is never written.
+ *
+ * @param _file_name is the saved bracket to read
+ * @throws invalid_argument if the file doesn't exist or isn't a whole save
+ */
+saved_reader::saved_reader(const string & _file_name) : team_table(nullptr),
+    slot_table(nullptr), names(nullptr), rounds(0), champion(NO_TEAM)
+{
+    lock_guard<mutex> lock(saved_file_lock());
+    saved_tables      tables;   // Header and tables of the save
+    const char *      bytes;    // Start of the save
+    size_t            size;     // Bytes in the save
+
+    saved.reset(new mapped_file(_file_name));
+    bytes = saved->data();
+    size  = saved->size();
+    if (size < sizeof(SAVED_MAGIC) || memcmp(bytes, SAVED_MAGIC, sizeof(SAVED_MAGIC)) != 0)
+    {
+        bracket parsed;     // Text save, parsed in memory
+        parsed.fill_bracket(bytes, size);
+        parsed.write_binary(converted);
+        saved.reset();
+        bytes = converted.data();
+        size  = converted.size();
+    }
+
+    read_saved_tables(bytes, size, tables);
+    header     = tables.header;
+    team_table = tables.teams;
+    slot_table = tables.slots;
+    names      = tables.names;
+    rounds     = floor_log2(header.num_teams);
+    if (header.version >= 2)
+        champion = saved_team_id(header.champion);
+
+    read_log(_file_name + ".log");
+}
+
+
+int saved_reader::num_teams() const  { return header.num_teams; }
+int saved_reader::num_rounds() const { return rounds; }
+team_id saved_reader::get_champion() const { return champion; }
+
+
+/**
+ * @brief Returns the teams in a slot, read from its record (or the edit log)
+ *
+ * @param _slot is the slot to read (0 is the final)
+ * @return pair<team_id, team_id>: the teams in the slot, NO_TEAM if empty
+ * @throws invalid_argument if the slot doesn't exist, or holds a bad team
+ */
+pair<team_id, team_id> saved_reader::get_slot(int _slot) const
+{
+    saved_slot             record;  // Record of the slot
+    pair<team_id, team_id> spot;    // Teams in the slot
+
+    if (_slot < 0 || _slot >= num_teams() - 1)
+        throw invalid_argument("No such slot in bracket.");
+    memcpy(&record, slot_table + (size_t)_slot * sizeof(record), sizeof(record));
+    spot = make_pair(saved_team_id(record.first), saved_team_id(record.second));
+
+    if (!logged.empty())
+    {
+        auto first  = logged.find(2 * (int64_t)_slot);
+        auto second = logged.find(2 * (int64_t)_slot + 1);
+        if (first != logged.end())
+            spot.first = first->second;
+        if (second != logged.end())
+            spot.second = second->second;
+    }
+    return spot;
+}
+
+
+/**
+ * @brief Returns a team, read from its record and the school names block
+ *
+ * @param _id is the id of the team
+ * @return team: the team, or an empty team for NO_TEAM or an unused id
+ * @throws invalid_argument if the id doesn't exist or its name is corrupt
+ */
+team saved_reader::get_team(team_id _id) const
+{
+    saved_team record;  // Record of the team
+
+    if (_id == NO_TEAM)
+        return team();
+    if (_id >= header.num_teams)
+        throw invalid_argument("Invalid seed in file.");
+    memcpy(&record, team_table + (size_t)_id * sizeof(record), sizeof(record));
+    if (record.seed == 0)
+        return team();
+    if (record.name_offset + (uint64_t)record.name_length > header.name_bytes)
+        throw invalid_argument("Saved bracket is corrupt (bad team name)");
+    return team(string(names + record.name_offset, record.name_length),
+        record.wins, record.losses, record.ties, record.seed);
+}
+
+
+/**
+ * @brief gives the slots of the last rounds, such as the Final Four (2)
+ *
+ * @param _rounds is the number of rounds, from 1 to num_rounds()
+ * @param _slots is filled with the slots (replacing what it held)
+ * @throws invalid_argument if the number of rounds is out of range
+ */
+void saved_reader::top_slots(int _rounds, vector<int> & _slots) const
+{
+    if (_rounds < 1 || _rounds > rounds)
+        throw invalid_argument("No such round in bracket.");
+    region_slots(0, rounds - _rounds, _slots);
+}
+
+
+/**
+ * @brief gives the slots of the games under a slot, a round at a time. The
+ *        games of one round under a slot are side by side in the heap order.
+ *
+ * @param _root is the slot at the top of the region
+ * @param _first_round is the earliest round to include (0 is the first round)
+ * @param _slots is filled with the slots (replacing what it held)
+ * @throws invalid_argument if the slot or round is out of range
+ */
+void saved_reader::region_slots(int _root, int _first_round, vector<int> & _slots) const
+{
+    int spots = num_teams() - 1;    // Slots in the tree
+    int round;                      // Round of the games being added
+    int first = _root;              // First slot of the games being added
+    int games = 1;                  // Games being added
+
+    if (_root < 0 || _root >= spots)
+        throw invalid_argument("No such slot in bracket.");
+    round = rounds - 1 - floor_log2(_root + 1);
+    if (_first_round < 0 || _first_round > round)
+        throw invalid_argument("No such round in bracket.");
+
+    _slots.clear();
+    for (; round >= _first_round; --round, first = 2*first + 1, games *= 2)
+        for (int i = 0; i < games; ++i)
+            _slots.push_back(first + i);
+}
+
+
+/**
+ * @brief gives the slots a team has played in. Team ids are seed - 1, so the
+ *        team's first game is found from the seeding order and checked; a
+ *        save that wasn't seeded that way is searched instead. Then the path
+ *        follows the team up until a slot doesn't hold it.
+ *
+ * @param _id is the id of the team
+ * @param _slots is filled with the slots, first game first (replacing what it
+ *        held), and left empty if the team isn't in the bracket
+ * @throws invalid_argument if the id doesn't exist
+ */
+void saved_reader::path_slots(team_id _id, vector<int> & _slots) const
+{
+    int    leaves = num_teams() / 2;    // Games in the first round
+    int    slot;                        // Slot on the team's path
+    pair<team_id, team_id> spot;
+
+    if (_id >= header.num_teams)
+        throw invalid_argument("No such team in bracket.");
+    _slots.clear();
+
+    slot = leaves - 1 + seed_order(num_teams()).position_of(_id + 1) / 2;
+    spot = get_slot(slot);
+    if (spot.first != _id && spot.second != _id)
+    {
+        for (slot = leaves - 1; slot < 2 * leaves - 1; ++slot)
+        {
+            spot = get_slot(slot);
+            if (spot.first == _id || spot.second == _id)
+                break;
+        }
+        if (slot == 2 * leaves - 1)
+            return;
+    }
+
+    _slots.push_back(slot);
+    while (slot > 0)
+    {
+        slot = (slot - 1) / 2;
+        spot = get_slot(slot);
+        if (spot.first != _id && spot.second != _id)
+            break;
+        _slots.push_back(slot);
+    }
+}
+
+
+/**
+ * @brief private helper that reads the save's edit log, if it has one for this
+ *        save, into the map of spots written since. A stale log is skipped
+ *        (fill_bracket() cleans it up).
+ *
+ * @param _log_file is the edit log of the save
+ * @throws invalid_argument if an edit is for a slot or team not in the bracket
+ */
+void saved_reader::read_log(const string & _log_file)
+{
+    saved_log_header log_header;    // Header of the log
+    error_code       err;
+
+    if (!filesystem::exists(_log_file, err))
+        return;
+
+    mapped_file log(_log_file);     // Whole log in memory
+    if (log.size() < sizeof(log_header))
+        return;
+    memcpy(&log_header, log.data(), sizeof(log_header));
+    if (memcmp(log_header.magic, SAVED_LOG_MAGIC, sizeof(SAVED_LOG_MAGIC)) != 0 ||
+        log_header.version != SAVED_LOG_VERSION || log_header.base != header.checksum)
+        return;
+
+    size_t records = (log.size() - sizeof(log_header)) / sizeof(saved_log_edit);
+    for (size_t i = 0; i < records; ++i)
+    {
+        saved_log_edit edit;
+        memcpy(&edit, log.data() + sizeof(log_header) + i * sizeof(edit), sizeof(edit));
+        if (edit.slot < -1 || edit.slot >= num_teams() - 1 || edit.second > 1)
+            throw invalid_argument("Saved bracket is corrupt (bad edit log)");
+        if (edit.slot < 0)
+            champion = saved_team_id(edit.team);
+        else
+            logged[2 * (int64_t)edit.slot + edit.second] = saved_team_id(edit.team);
+    }
+}
+
+
+// private helper that turns a team id from the save into a team_id
+team_id saved_reader::saved_team_id(uint32_t _id) const
+{
+    if (_id == SAVED_NO_TEAM)
+        return NO_TEAM;
+    if (_id >= header.num_teams)
+        throw invalid_argument("Invalid seed in file.");
+    return _id;
+}
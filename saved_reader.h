@@ -0,0 +1,78 @@
+/**
+ * @file saved_reader.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the saved_reader class which reads parts of a
+ *        saved bracket without loading the rest of it.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SAVED_READER
+#define SAVED_READER
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <utility>
+#include <mutex>
+#include <cstdint>
+#include "bracket.h"
+#include "mapped_file.h"
+#include "saved_format.h"
+#include "seed_order.h"
+#include "team.h"
+#include "utils.h"
+
+/**
+ * @brief Reads single games and teams out of a saved bracket. The binary save
+ *        (see saved_format.h) is its own offset index: the team table and the
+ *        slot array are fixed width and in heap order, so the record of any
+ *        slot or team is at an offset worked out from its index. The save is
+ *        memory mapped and only the pages holding the records asked for are
+ *        ever read from disk. The save's edit log is read whole (it is kept
+ *        small) and laid over the slots. The checksum covers the whole save
+ *        and can't be checked without reading all of it, so each record read
+ *        is range checked instead. The slot helpers give the slots a dashboard
+ *        usually wants: the last rounds, a region, or one team's path. A text
+ *        save is parsed and laid out in the binary format in memory instead,
+ *        so reading never changes the file.
+ */
+class saved_reader : protected utils
+{
+    public:
+        saved_reader(const std::string & _file_name);   // Param. constructor
+
+        int  num_teams() const;                 // Number of teams in bracket
+        int  num_rounds() const;                // Number of rounds of games
+        // Teams in a slot of the heap-ordered tree (0 is the final)
+        std::pair<team_id, team_id> get_slot(int _slot) const;
+        // Winner of the final (NO_TEAM if it hasn't been decided)
+        team_id get_champion() const;
+        // Team from the team table (NO_TEAM gives an empty team)
+        team get_team(team_id _id) const;
+
+        // Slots of the last _rounds rounds, the final first
+        void top_slots(int _rounds, std::vector<int> & _slots) const;
+        // Slots of the games under _root from _first_round (0 is the first
+        // round) up, _root first
+        void region_slots(int _root, int _first_round, std::vector<int> & _slots) const;
+        // Slots a team has played in, from its first game to its furthest
+        void path_slots(team_id _id, std::vector<int> & _slots) const;
+
+    private:
+        std::unique_ptr<mapped_file> saved;     // Whole save, mapped
+        std::string  converted;                 // Binary layout of a text save
+        saved_header header;                    // Header of the save
+        const char * team_table;                // Start of the team records
+        const char * slot_table;                // Start of the slot records
+        const char * names;                     // Start of the school names
+        int          rounds;                    // Rounds of games
+        team_id      champion;                  // Winner of the final
+        // Teams written since the save by its edit log, [slot*2 + side]
+        std::unordered_map<std::int64_t, team_id> logged;
+
+        void read_log(const std::string & _log_file);
+        team_id saved_team_id(std::uint32_t _id) const;
+};
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ * @file seed_order.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the seed_order class which works out
+ *        the seeded matchup order of a first round in closed form.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "seed_order.h"
+using namespace std;
+
+/**
+ * @brief Param. constructor
+ *
+ * @param _teams is the number of teams, a power of two of at least 2
+ * @throws invalid_argument if the number of teams isn't a power of two
+ */
+seed_order::seed_order(int _teams) : teams(_teams)
+{
+    if (_teams < 2 || !is_pow_two(_teams))
+        throw invalid_argument("Number of teams isn't power of two.");
+    rounds = floor_log2(_teams);
+}
+
+
+int seed_order::num_teams() const { return teams; }
+
+
+/**
+ * @brief finds the seed at a position by following the position's bits from
+ *        the top. Each bit picks a side of the game the seed so far grows into
+ *        at the next size, either the seed itself or its opponent.
+ *
+ * @param _position is the first round position, from 0 to teams - 1
+ * @return int: the seed at the position
+ * @throws invalid_argument if the position is out of range
+ */
+int seed_order::seed_at(int _position) const
+{
+    int seed = 1;   // Seed at the position in the order of each size
+
+    if (_position < 0 || _position >= teams)
+        throw invalid_argument("No such position in bracket.");
+
+    for (int size = 2, shift = rounds - 1; shift >= 0; size *= 2, --shift)
+        seed = grow(size, _position >> shift, seed);
+    return seed;
+}
+
+
+/**
+ * @brief finds the position of a seed. Going from the full order down, the
+ *        better seed of each game is the one carried to the order half its
+ *        size, which gives the seed at every size. Then going back up, each
+ *        size adds one bit to the position: whether the seed there is the
+ *        carried one, flipped if its game is swapped.
+ *
+ * @param _seed is the seed, from 1 to teams
+ * @return int: the first round position of the seed (0 is the top)
+ * @throws invalid_argument if the seed is out of range
+ */
+int seed_order::position_of(int _seed) const
+{
+    int seeds[32];      // Seed carried down to each size, [r] for 2^r teams
+    int position = 0;   // Position in the order of each size
+
+    if (_seed < 1 || _seed > teams)
+        throw invalid_argument("No such seed in bracket.");
+
+    seeds[rounds] = _seed;
+    for (int r = rounds; r > 0; --r)
+        seeds[r - 1] = min(seeds[r], (1 << r) + 1 - seeds[r]);
+
+    for (int r = 1; r <= rounds; ++r)
+    {
+        bool opponent = seeds[r] != seeds[r - 1];   // Lower seed of its game
+        position = 2 * position + (opponent != swapped(1 << r, position));
+    }
+    return position;
+}
+
+
+/**
+ * @brief lays out the whole order by growing it in place one size at a time.
+ *        Each position's seed only needs the seed at half its position, and
+ *        going from the back that seed hasn't been overwritten yet, so every
+ *        size takes one pass and all of them take under 2n steps.
+ *
+ * @param _seeds is filled with the seed at each position
+ */
+void seed_order::fill(vector<int> & _seeds) const
+{
+    _seeds.assign(teams, 0);
+    _seeds[0] = 1;
+    for (int size = 2; size <= teams; size *= 2)
+        for (int i = size - 1; i >= 0; --i)
+            _seeds[i] = grow(size, i, _seeds[i >> 1]);
+}
+
@@ -0,0 +1,60 @@
+/**
+ * @file seed_order.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the seed_order class which works out the seeded
+ *        matchup order of a bracket's first round in closed form.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SEED_ORDER
+#define SEED_ORDER
+
+#include <vector>
+#include <stdexcept>
+#include "utils.h"
+
+/**
+ * @brief The order seeds are placed in down the first round of a bracket, so
+ *        the best seeds meet as late as possible. EXAMPLE (8 teams):
+ *        1 8 5 4 2 7 6 3, which plays 1v8, 5v4, 2v7 and 6v3. The order for n
+ *        teams comes from the order for n/2: the seed s at position p becomes
+ *        the game s v n+1-s at positions 2p and 2p+1, swapped when p is odd
+ *        (from 8 teams on, 4 teams is 1 4 2 3). So the seed at any position
+ *        follows from the bits of the position, and a position from the seeds
+ *        on the way down, in O(log n) each with nothing stored, and the whole
+ *        order can be laid out in O(n).
+ */
+class seed_order : protected utils
+{
+    public:
+        seed_order(int _teams);         // Param. constructor
+
+        int  num_teams() const;         // Number of teams in the order
+        // Seed at a first round position (0 is the top), in O(log n)
+        int  seed_at(int _position) const;
+        // First round position of a seed, in O(log n)
+        int  position_of(int _seed) const;
+        // Seed at every position, in O(n)
+        void fill(std::vector<int> & _seeds) const;
+
+        // Seed at a position in the order of a size, from the seed at half the
+        // position in the order half the size
+        static constexpr int grow(int _size, int _position, int _seed)
+        {
+            return (_position & 1) != swapped(_size, _position >> 1) ?
+                _size + 1 - _seed : _seed;
+        }
+
+    private:
+        int teams;      // Number of teams (2^x)
+        int rounds;     // Halvings from teams down to 1
+
+        // If a game in the order of a size has the worse seed on top, from the
+        // position it grew from in the order half the size
+        static constexpr bool swapped(int _size, int _parent)
+        {
+            return _size > 4 && (_parent & 1);
+        }
+};
+
+#endif
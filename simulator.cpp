@@ -0,0 +1,347 @@
+/**
+ * @file simulator.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the simulator class which plays out
+ *        brackets to estimate each team's odds.
+ * 
+ * @copyright Copyright (c) 2022
+ */
+#include "simulator.h"
+using namespace std;
+
+/**
+ * @brief Param. constructor that takes a snapshot of the bracket's matchups,
+ *        which games are decided, and each team's strength.
+ * 
+ * @param _source is the bracket to simulate
+ */
+simulator::simulator(const bracket & _source)
+    : source(_source), rounds(_source.num_rounds())
+{
+    int spots = _source.num_teams() - 1;    // Slots in the bracket
+
+    matchups.resize(spots);
+    decided.assign(spots, NO_TEAM);
+    slot_rounds.resize(spots);
+    for (int i = 0; i < spots; ++i)
+    {
+        matchups[i] = _source.get_slot(i).get_pair();
+
+        // Winner of a game sits in the parent slot, on the side it came from
+        if (i > 0)
+        {
+            const pair<team_id, team_id> & next = _source.get_slot((i - 1) / 2).get_pair();
+            decided[i] = i % 2 ? next.first : next.second;
+        }
+        else
+            decided[i] = _source.get_champion();
+
+        slot_rounds[i] = _source.slot_round(i);
+    }
+
+    strengths.resize(_source.num_teams());
+    for (int i = 0; i < _source.num_teams(); ++i)
+        strengths[i] = _source.get_team(i).strength(_source.num_teams());
+    odds.assign(_source.num_teams() * (rounds + 1), 0);
+}
+
+
+/**
+ * @brief Plays the whole tournament _trials times and records how often each
+ *        team reaches each round. Trials are split evenly over threads, and
+ *        every thread draws from its own stream seeded by (_seed, thread), so
+ *        the same seed and thread count always give the same odds. A thread
+ *        counts up to UINT32_MAX trials at a time in its own 32-bit counts,
+ *        and adds them into the odds after each batch. There are only as many
+ *        threads as have room for their counts in MAX_SIM_COUNT_BYTES.
+ * 
+ * @param _trials is the number of tournaments to play
+ * @param _seed is the seed for the random streams
+ * @param _threads is the number of threads to use (0 for every core)
+ */
+void simulator::monte_carlo(long long _trials, unsigned long long _seed,
+    int _threads)
+{
+    vector<thread> workers;     // Threads playing trials
+    mutex          merging;     // Held while a thread adds into the odds
+    size_t         table = odds.size() * sizeof(uint32_t);  // Bytes of counts
+
+    if (_trials < 1)
+        throw invalid_argument("Number of trials must be positive.");
+    if (_threads < 1)
+        _threads = max(1u, thread::hardware_concurrency());
+    _threads = (int)max<size_t>(1,
+        min<size_t>(_threads, MAX_SIM_COUNT_BYTES / table));
+
+    odds.assign(odds.size(), 0);
+    for (int t = 0; t < _threads; ++t)
+    {
+        long long share = _trials / _threads + (t < _trials % _threads);
+        workers.push_back(thread([this, share, _seed, t, &merging]() {
+            seed_seq         stream = {(unsigned)_seed, (unsigned)(_seed >> 32),
+                (unsigned)t};
+            mt19937_64       rng(stream);   // Random stream of this thread
+            vector<uint32_t> reached;       // Counts of this batch
+
+            for (long long done = 0; done < share; )
+            {
+                long long batch = min<long long>(share - done, UINT32_MAX);
+
+                reached.assign(odds.size(), 0);
+                simulate(batch, rng, reached);
+                lock_guard<mutex> lock(merging);
+                for (size_t i = 0; i < reached.size(); ++i)
+                    odds[i] += reached[i];
+                done += batch;
+            }
+        }));
+    }
+    for (int t = 0; t < _threads; ++t)
+        workers[t].join();
+
+    for (double & count : odds)
+        count /= _trials;
+}
+
+
+/**
+ * @brief Plays the tournament _trials times on one thread. Games are played
+ *        from the first round up to the final, so both teams of a game are
+ *        known by the time it is played.
+ * 
+ * @param _trials is the number of tournaments to play (at most UINT32_MAX)
+ * @param _rng is this thread's random stream
+ * @param _reached is the count of times each team reached each round
+ */
+void simulator::simulate(long long _trials, mt19937_64 & _rng,
+    vector<uint32_t> & _reached) const
+{
+    vector<team_id> winners(matchups.size());       // Winner of each slot
+    int             width = rounds + 1;             // Rounds per team in counts
+
+    if (with_fixed_size(strengths.size(), [&](auto _teams) {
+            simulate_fixed<decltype(_teams)::value>(_trials, _rng, _reached);
+        }))
+        return;
+
+    for (long long trial = 0; trial < _trials; ++trial)
+    {
+        for (int i = (int)matchups.size() - 1; i >= 0; --i)
+        {
+            team_id first  = matchups[i].first;
+            team_id second = matchups[i].second;
+            team_id winner = decided[i];
+
+            // Empty spots are filled by the winner of the game below
+            if (first == NO_TEAM)
+                first = winners[2*i + 1];
+            if (second == NO_TEAM)
+                second = winners[2*i + 2];
+            _reached[first * width + slot_rounds[i]]  += 1;
+            _reached[second * width + slot_rounds[i]] += 1;
+
+            if (winner == NO_TEAM)
+            {
+                // Top 53 bits of the draw as a double in [0, 1)
+                double roll = (_rng() >> 11) * (1.0 / 9007199254740992.0);
+                winner = roll < win_chance(first, second) ? first : second;
+            }
+            winners[i] = winner;
+        }
+        _reached[winners[0] * width + rounds] += 1;
+    }
+}
+
+
+/**
+ * @brief Plays the tournament _trials times on one thread, for a bracket of N
+ *        teams. Plays the same games with the same draws as simulate(), but
+ *        the matchups, winners and counts live in arrays on the stack, the
+ *        loops have constant bounds, and the chance of every possible game is
+ *        worked out once before the first trial.
+ *
+ * @param _trials is the number of tournaments to play (at most UINT32_MAX)
+ * @param _rng is this thread's random stream
+ * @param _reached is the count of times each team reached each round
+ */
+template <int N>
+void simulator::simulate_fixed(long long _trials, mt19937_64 & _rng,
+    vector<uint32_t> & _reached) const
+{
+    using games = fixed_bracket<N>;
+    constexpr int WIDTH = games::ROUNDS + 1;    // Rounds per team in counts
+
+    array<pair<team_id, team_id>, games::SPOTS>  fixed_matchups;
+    array<team_id, games::SPOTS>                 fixed_decided;
+    array<team_id, games::SPOTS>                 winners{};     // Winner of each slot
+    array<double, N * N>                         chances;       // [first * N + second]
+    array<long long, N * WIDTH>                  reached{};     // Counts of this thread
+
+    copy(matchups.begin(), matchups.end(), fixed_matchups.begin());
+    copy(decided.begin(), decided.end(), fixed_decided.begin());
+    for (int a = 0; a < N; ++a)
+        for (int b = 0; b < N; ++b)
+            chances[a * N + b] = win_chance(a, b);
+
+    for (long long trial = 0; trial < _trials; ++trial)
+    {
+        for (int i = games::SPOTS - 1; i >= 0; --i)
+        {
+            team_id first  = fixed_matchups[i].first;
+            team_id second = fixed_matchups[i].second;
+            team_id winner = fixed_decided[i];
+
+            // Empty spots are filled by the winner of the game below
+            if (first == NO_TEAM)
+                first = winners[2*i + 1];
+            if (second == NO_TEAM)
+                second = winners[2*i + 2];
+            reached[first * WIDTH + games::SLOT_ROUNDS[i]]  += 1;
+            reached[second * WIDTH + games::SLOT_ROUNDS[i]] += 1;
+
+            if (winner == NO_TEAM)
+            {
+                double roll = (_rng() >> 11) * (1.0 / 9007199254740992.0);
+                winner = roll < chances[first * N + second] ? first : second;
+            }
+            winners[i] = winner;
+        }
+        reached[winners[0] * WIDTH + games::ROUNDS] += 1;
+    }
+
+    for (int i = 0; i < N * WIDTH; ++i)
+        _reached[i] += reached[i];
+}
+
+
+/**
+ * @brief Works out each team's odds of reaching each round exactly. Teams are
+ *        laid out by their first round position (the seeded matchup order the
+ *        bracket was built with), so every slot covers one block of positions
+ *        whose halves are the two sides of its game. Going a round at a time,
+ *        a team's chance of winning its slot is its chance of winning the slot
+ *        below times its chance of beating whoever comes out of the other
+ *        half. Each game compares every team in one half with every team in the
+ *        other, so the whole bracket takes O(n^2). Decided games keep their
+ *        winner with a chance of 1.
+ */
+void simulator::exact()
+{
+    int             teams = matchups.size() + 1;    // Number of teams
+    int             width = rounds + 1;             // Rounds per team in odds
+    int             first_round = teams / 2 - 1;    // Slot of first game
+    vector<team_id> positions(teams);   // Team at each first round position
+    vector<double>  won(teams, 1);      // Chance team won its last slot
+    vector<double>  winning(teams);     // Chance team wins its current slot
+
+    for (int i = first_round; i < (int)matchups.size(); ++i)
+    {
+        positions[2*(i - first_round)]     = matchups[i].first;
+        positions[2*(i - first_round) + 1] = matchups[i].second;
+    }
+    odds.assign(odds.size(), 0);
+
+    for (int r = 0; r < rounds; ++r)
+    {
+        int first = (teams >> (r + 1)) - 1;     // First slot of the round
+        int block = 2 << r;                     // Positions under each slot
+        int half  = block / 2;                  // Positions on each side
+
+        for (int k = 0; k <= first; ++k)
+        {
+            int base = k * block;               // First position of the slot
+
+            for (int p = base; p < base + block; ++p)
+            {
+                odds[positions[p] * width + r] += won[p];
+                winning[p] = 0;
+            }
+
+            if (decided[first + k] != NO_TEAM)
+            {
+                for (int p = base; p < base + block; ++p)
+                    winning[p] = positions[p] == decided[first + k];
+                continue;
+            }
+
+            // Every team on the left plays every team on the right
+            for (int p = base; p < base + half; ++p)
+                for (int q = base + half; q < base + block; ++q)
+                {
+                    double chance = win_chance(positions[p], positions[q]);
+                    winning[p] += won[q] * chance;
+                    winning[q] += won[p] * (1 - chance);
+                }
+            for (int p = base; p < base + block; ++p)
+                winning[p] *= won[p];
+        }
+        won.swap(winning);
+    }
+
+    for (int p = 0; p < teams; ++p)
+        odds[positions[p] * width + rounds] = won[p];
+}
+
+
+/**
+ * @brief Chance the first team beats the second using the log5 method on the
+ *        teams' strengths.
+ * 
+ * @param _first is the id of the first team
+ * @param _second is the id of the second team
+ * @return double: the chance the first team wins
+ */
+double simulator::win_chance(team_id _first, team_id _second) const
+{
+    double a = strengths[_first];
+    double b = strengths[_second];
+
+    return a * (1 - b) / (a * (1 - b) + b * (1 - a));
+}
+
+
+/**
+ * @brief Returns the chance a team reached a round in the last simulation.
+ * 
+ * @param _id is the id of the team
+ * @param _round is the round (0 is the first round, num_rounds() is winning
+ *               the title)
+ * @return double: the chance, between 0 and 1
+ */
+double simulator::get_odds(team_id _id, int _round) const
+{
+    return odds[_id * (rounds + 1) + _round];
+}
+
+
+/**
+ * @brief Prints each team with its odds of reaching each round after the first
+ *        and of winning the title, in the round labels of bracket::draw().
+ */
+void simulator::display() const
+{
+    ios_base::fmtflags flags = cout.flags();    // Format to restore after
+
+    // Header
+    cout << left << setw(SIZE_PAIR_PADDING) << setfill(' ') << "TEAM";
+    for (int r = 1; r < rounds; ++r)
+        cout << left << setw(SIZE_PAIR_PADDING) << setfill(' ') << source.round_name(r);
+    cout << "CHAMPION" << endl
+         << setw(rounds * SIZE_PAIR_PADDING + 8) << setfill('=') << '=' << endl;
+
+    // Teams in seed order
+    cout << fixed << setprecision(1);
+    for (int i = 0; i < source.num_teams(); ++i)
+    {
+        source.get_team(i).display_in_bracket();
+        cout << "   ";
+        for (int r = 1; r <= rounds; ++r)
+        {
+            cout << right << setw(5) << setfill(' ') << get_odds(i, r) * 100 << '%';
+            if (r < rounds)
+                cout << setw(SIZE_PAIR_PADDING - 6) << ' ';
+        }
+        cout << endl;
+    }
+    cout.flags(flags);
+}
@@ -0,0 +1,71 @@
+/**
+ * @file simulator.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the simulator class which estimates how far each
+ *        team in a bracket is likely to advance.
+ * 
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SIMULATOR
+#define SIMULATOR
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <random>
+#include <cstdint>
+#include "bracket.h"
+#include "fixed_bracket.h"
+
+// Most bytes the threads of simulator::monte_carlo() keep counts in at once
+static const std::size_t MAX_SIM_COUNT_BYTES = 1 << 28;
+
+/**
+ * @brief Plays out a bracket many times to find the chance each team has of
+ *        reaching every round. Each game is won by a team with a chance that
+ *        comes from both teams' strength (see team::strength()). Games that
+ *        have already been decided in the bracket keep their winner. Trials are
+ *        split over threads with their own random stream, so the results only
+ *        depend on the seed and the number of threads. Each thread counts in
+ *        its own table of 32-bit counts, so large brackets get only as many
+ *        threads as MAX_SIM_COUNT_BYTES has room for (at least one). exact()
+ *        gives the same odds without sampling noise by combining, for every
+ *        slot, the chances of each team being in it. Brackets of a common size
+ *        are played with the size built in (see fixed_bracket.h), with every
+ *        game's chance worked out up front. The bracket must outlive the simulator.
+ */
+class simulator
+{
+    public:
+        simulator(const bracket &);     // Param. constructor
+
+        // Plays the tournament _trials times (0 threads uses every core)
+        void monte_carlo(long long _trials, unsigned long long _seed = 0,
+            int _threads = 0);
+        // Works out the odds exactly, in O(n^2) for n teams
+        void exact();
+        // Chance a team reaches a round (num_rounds() is winning the title)
+        double get_odds(team_id _id, int _round) const;
+        // Prints every team's odds of reaching each round
+        void display() const;
+
+    private:
+        const bracket &              source;        // Bracket being simulated
+        int                          rounds;        // Number of rounds
+        std::vector<std::pair<team_id, team_id>> matchups; // Slots of bracket
+        std::vector<team_id>         decided;       // Winner of slot, if any
+        std::vector<int>             slot_rounds;   // Round of each slot
+        std::vector<double>          strengths;     // Strength of each team
+        std::vector<double>          odds;          // [team * (rounds+1) + round]
+
+        void simulate(long long _trials, std::mt19937_64 & _rng,
+            std::vector<std::uint32_t> & _reached) const;
+        template <int N>
+        void simulate_fixed(long long _trials, std::mt19937_64 & _rng,
+            std::vector<std::uint32_t> & _reached) const;
+        double win_chance(team_id, team_id) const;
+};
+
+#endif
@@ -21,7 +21,8 @@ team::team(string _school_name, int _wins, int _losses, int _ties, int _seed)
 
 
 /**
- * @brief Setter for all elements of team.
+ * @brief Setter for all elements of team. The name is copied into the memory
+ *        the old name had when it fits, so refilling a team doesn't allocate.
  * 
  * @param _school_name  Name of school
  * @param _wins         Number of team wins
@@ -29,9 +30,9 @@ team::team(string _school_name, int _wins, int _losses, int _ties, int _seed)
  * @param _ties         Number of team ties
  * @param _seed         Team's seed in playoffs
  */
-void team::set_team(string _school_name, int _wins, int _losses, int _ties, int _seed)
+void team::set_team(string_view _school_name, int _wins, int _losses, int _ties, int _seed)
 {
-    school_name = _school_name;
+    school_name.assign(_school_name);
     wins        = _wins;
     losses      = _losses;
     ties        = _ties;
@@ -60,13 +61,31 @@ void team::display() const
  */
 void team::display_in_bracket() const
 {
-    cout << " " << setw(2) << setfill(' ') << left << seed << " ";
+    cout << bracket_label();
+}
+
+
+/**
+ * @brief Builds the condensed format used by display_in_bracket(), 15 chars
+ *        for a seed of up to two digits, shown below...
+ * EXAMPLE:
+ *  ## CENTRAL CA 
+ * 
+ * @return string: the label
+ */
+string team::bracket_label() const
+{
+    string label = " " + to_string(seed);   // Label being built
+
+    // Seed is left aligned in two chars
+    if (label.size() < 3)
+        label += ' ';
+    label += ' ';
     // Display full name or condescensed with filler if less than 10 chars
-    if (school_name.size() > 10)
-        cout << school_name.substr(0, 10);
-    else
-        cout << setw(10) << setfill(' ') << left << school_name;
-    cout << " ";
+    label += school_name.substr(0, 10);
+    label.append(10 - min<size_t>(school_name.size(), 10), ' ');
+    label += ' ';
+    return label;
 }
 
 
@@ -94,6 +113,13 @@ int team::get_seed() const
 }
 
 
+// Getters for the team record
+int team::get_wins() const   { return wins; }
+int team::get_losses() const { return losses; }
+int team::get_ties() const   { return ties; }
+const string & team::get_name() const { return school_name; }
+
+
 /**
  * @brief Checks if arg seed is the same as the team seed.
  * 
@@ -120,6 +146,25 @@ bool team::same_name(const string & _school_name) const
 }
 
 
+/**
+ * @brief Rates the team between 0 and 1 by blending its season record with its
+ *        seed. Ties count as half a win, and the record is padded with one win
+ *        and one loss so an unbeaten or winless team is never certain.
+ * EXAMPLE (32 teams):
+ * 8-1-0, seed 1  -> (0.82 + 0.97) / 2 = 0.89
+ * 
+ * @param _num_teams is the number of teams seeded in the playoffs
+ * @return double: the team's strength, strictly between 0 and 1
+ */
+double team::strength(int _num_teams) const
+{
+    double record = (wins + 0.5*ties + 1) / (wins + losses + ties + 2);
+    double rank   = (double)(_num_teams - seed + 1) / (_num_teams + 1);
+
+    return (record + rank) / 2;
+}
+
+
 /**
  * @brief Prints team for file output that can be read by team::read_team(). The
  *        format is below...
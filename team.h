@@ -10,9 +10,15 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <iomanip>
+#include <cstdint>
+#include <algorithm>
 #include "utils.h"
 
+typedef std::uint32_t team_id;              // Index of a team in a team table
+static const team_id NO_TEAM = 0xFFFFFFFF;  // Empty (NONE) spot in a bracket
+
 /**
  * @brief Holds information for a school team including name, wins, losses, ties
  *        and seed. It can be displayed in various ways, and used to compare
@@ -26,15 +32,22 @@ class team : protected utils
 
         void display()              const;      // Listed display
         void display_in_bracket()   const;      // Display in # SCHOOL_NAME format
+        std::string bracket_label() const;      // # SCHOOL_NAME format as string
         // Check if team's seed is less than 1 or greater than arg
         bool invalid_rank(int)      const;
         int  get_seed()             const;      // Returns team seed
+        int  get_wins()             const;      // Returns team wins
+        int  get_losses()           const;      // Returns team losses
+        int  get_ties()             const;      // Returns team ties
+        const std::string & get_name() const;   // Returns school name
         bool same_seed(int)         const;      // Checks for match with arg
         bool same_name(const std::string &) const;  // Checks for match with arg
+        // Rating between 0 and 1 from the team's record and seed
+        double strength(int _num_teams) const;
         void print_for_file(std::ostream &) const;  // Prints team in file input format
         void read_team(std::istream &, char delim); // Reads team from file input
         void read_team(char delim);             // Reads team from user input
-        void set_team(std::string, int, int, int, int); // Setter for all elements
+        void set_team(std::string_view, int, int, int, int);  // Setter for all elements
         void edit_team();                       // Edit team via input from user
 
     private:
@@ -0,0 +1,198 @@
+/**
+ * @file terminal_view.cpp
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds method definitions for the terminal_view class which repaints
+ *        the changed cells of a bracket with ANSI escape codes.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "terminal_view.h"
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+#else
+#include <unistd.h>
+#include <sys/ioctl.h>
+#endif
+using namespace std;
+
+/**
+ * @brief Param. constructor that checks if output is a terminal that can be
+ *        repainted in place
+ *
+ * @param _source is the bracket to show
+ */
+terminal_view::terminal_view(const bracket & _source)
+    : source(_source), renderer(_source), painted_champion(NO_TEAM),
+      ansi(false), live(false)
+{
+    int rows, columns;  // Size of the terminal window
+
+    ansi = terminal_size(rows, columns);
+}
+
+
+/**
+ * @brief Checks if redraw() repaints cells in place rather than drawing the
+ *        whole bracket again.
+ *
+ * @return true if the last draw() was to a terminal it fit in
+ */
+bool terminal_view::is_live() const
+{
+    return live;
+}
+
+
+/**
+ * @brief draws the whole bracket. On a terminal it fits in, the screen is
+ *        cleared first so the bracket starts on the top line, which is what
+ *        the remembered cell positions are counted from.
+ */
+void terminal_view::draw()
+{
+    string buffer;          // Whole bracket
+    int    rows, columns;   // Size of the terminal window
+
+    renderer.render(buffer);
+    live = ansi && terminal_size(rows, columns) &&
+        renderer.height() + PROMPT_LINES <= rows && renderer.width() < columns;
+    if (live)
+        buffer.insert(0, "\x1b[H\x1b[2J");
+
+    // Remember what went in each cell
+    painted.resize(2 * (source.num_teams() - 1));
+    for (int i = 0; i < source.num_teams() - 1; ++i)
+    {
+        painted[2*i]     = source.get_slot(i).get_pair().first;
+        painted[2*i + 1] = source.get_slot(i).get_pair().second;
+    }
+    painted_champion = source.get_champion();
+
+    cout.write(buffer.data(), buffer.size());
+    cout.flush();
+}
+
+
+/**
+ * @brief repaints every cell whose team changed since it was painted. The
+ *        cursor is saved first and put back after, so input carries on where
+ *        it was. A new (or cleared) champion adds (or removes) lines under the
+ *        final, so it gets a full draw, as does any output that isn't live.
+ */
+void terminal_view::redraw()
+{
+    string buffer = "\x1b" "7";     // Escapes to paint changed cells
+
+    if (!live || (painted_champion == NO_TEAM) != (source.get_champion() == NO_TEAM))
+    {
+        draw();
+        return;
+    }
+
+    for (int i = 0; i < source.num_teams() - 1; ++i)
+    {
+        const pair<team_id, team_id> & spot = source.get_slot(i).get_pair();
+        if (spot.first != painted[2*i])
+        {
+            paint_cell(renderer.cell_line(i, 0), renderer.cell_column(i, 0),
+                spot.first, buffer);
+            painted[2*i] = spot.first;
+        }
+        if (spot.second != painted[2*i + 1])
+        {
+            paint_cell(renderer.cell_line(i, 1), renderer.cell_column(i, 1),
+                spot.second, buffer);
+            painted[2*i + 1] = spot.second;
+        }
+    }
+    if (source.get_champion() != painted_champion)
+    {
+        paint_cell(renderer.champion_line(), renderer.champion_column(),
+            source.get_champion(), buffer);
+        painted_champion = source.get_champion();
+    }
+
+    // Nothing changed
+    if (buffer.size() == 2)
+        return;
+    buffer += "\x1b" "8";
+    cout.write(buffer.data(), buffer.size());
+    cout.flush();
+}
+
+
+/**
+ * @brief clears everything under the bracket (leaving a blank line) and puts
+ *        the cursor there, so input and messages don't scroll the bracket off
+ *        the top of the screen. Does nothing if the view isn't live.
+ */
+void terminal_view::clear_prompt()
+{
+    string buffer;  // Escapes to move and clear
+
+    if (!live)
+        return;
+    buffer = "\x1b[" + to_string(renderer.height() + 2) + ";1H\x1b[J";
+    cout.write(buffer.data(), buffer.size());
+    cout.flush();
+}
+
+
+/**
+ * @brief private helper that moves the cursor to a cell and paints a label
+ *
+ * @param _line is the line of the cell, from 0
+ * @param _column is the column of the cell, from 0
+ * @param _id is the team to paint
+ * @param _out is the buffer to add to
+ */
+void terminal_view::paint_cell(int _line, int _column, team_id _id,
+    string & _out) const
+{
+    _out += "\x1b[";
+    _out += to_string(_line + 1);
+    _out += ';';
+    _out += to_string(_column + 1);
+    _out += 'H';
+    _out += renderer.label(_id);
+}
+
+
+/**
+ * @brief private helper that checks standard output is a terminal that takes
+ *        ANSI escape codes, and gets the size of its window. On Windows the
+ *        console is switched to take escape codes.
+ *
+ * @param _rows is set to the rows in the window
+ * @param _columns is set to the columns in the window
+ * @return true if standard output is a terminal that takes escape codes
+ */
+bool terminal_view::terminal_size(int & _rows, int & _columns) const
+{
+#ifdef _WIN32
+    HANDLE                     out = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD                      mode;
+    CONSOLE_SCREEN_BUFFER_INFO info;
+
+    if (!_isatty(_fileno(stdout)) || !GetConsoleMode(out, &mode) ||
+        !SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING) ||
+        !GetConsoleScreenBufferInfo(out, &info))
+        return false;
+    _rows    = info.srWindow.Bottom - info.srWindow.Top + 1;
+    _columns = info.srWindow.Right - info.srWindow.Left + 1;
+#else
+    const char *   term = getenv("TERM");   // Terminal type
+    struct winsize size;
+
+    if (!isatty(STDOUT_FILENO) || !term || strcmp(term, "dumb") == 0 ||
+        ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_row == 0)
+        return false;
+    _rows    = size.ws_row;
+    _columns = size.ws_col;
+#endif
+    return true;
+}
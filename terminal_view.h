@@ -0,0 +1,57 @@
+/**
+ * @file terminal_view.h
+ * @author Henry Kaus (https://github.com/henrykaus)
+ * @brief Holds definition for the terminal_view class which keeps a bracket on
+ *        the screen and repaints only what changed.
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TERMINAL_VIEW
+#define TERMINAL_VIEW
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "bracket.h"
+#include "bracket_renderer.h"
+
+static const int PROMPT_LINES = 17;     // Rows kept under bracket for input
+
+/**
+ * @brief Shows a bracket in the terminal while it is being edited. On a
+ *        terminal that takes ANSI escape codes, draw() clears the screen and
+ *        draws the bracket at the top, and remembers the team it painted in
+ *        each cell. redraw() then compares every cell with the bracket and
+ *        moves the cursor to just the cells that changed to paint over them,
+ *        so an advance costs a few bytes instead of the whole bracket. Input
+ *        and messages go below the bracket, and clear_prompt() wipes them
+ *        before the next edit so the screen never scrolls. When output isn't a
+ *        terminal, or the bracket doesn't fit in the window, every redraw() is
+ *        a full draw instead. The bracket must outlive the view.
+ */
+class terminal_view
+{
+    public:
+        terminal_view(const bracket &);     // Param. constructor
+
+        bool is_live() const;       // Checks if cells are repainted in place
+        void draw();                // Draw the whole bracket
+        void redraw();              // Repaint the cells that changed
+        void clear_prompt();        // Clear input and messages under bracket
+
+    private:
+        const bracket &      source;    // Bracket being shown
+        bracket_renderer     renderer;  // Lays out bracket and knows its cells
+        std::vector<team_id> painted;   // Team painted in each cell
+        team_id              painted_champion;  // Champion painted, if any
+        bool                 ansi;      // If output is an ANSI terminal
+        bool                 live;      // If the last draw fit on the screen
+
+        void paint_cell(int _line, int _column, team_id _id, std::string & _out) const;
+        bool terminal_size(int & _rows, int & _columns) const;
+};
+
+#endif
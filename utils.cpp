@@ -7,6 +7,12 @@
  * @copyright Copyright (c) 2022
  */
 #include "utils.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 using namespace std;
 
 
@@ -31,6 +37,7 @@ bool utils::is_pow_two(int _num) const
  * @param _min is the minimum integer the number can be (default: INT_MIN)
  * @param _max is the maximum integer the number can be (default: INT_MAX)
  * @return int of the number the user input
+ * @throws invalid_argument if input ends before a valid number
  */
 int utils::integer_input(std::istream & in, const char * _err_msg, int _min, int _max) const
 {
@@ -40,6 +47,8 @@ int utils::integer_input(std::istream & in, const char * _err_msg, int _min, int
     in >> number;
     while (in.fail() || number < _min || number > _max)
     {
+        if (in.eof())
+            throw invalid_argument("Input ended.");
         in.clear();
         in.ignore(10000, '\n');
         if (_err_msg)
@@ -59,6 +68,7 @@ int utils::integer_input(std::istream & in, const char * _err_msg, int _min, int
  * @param _min is the minimum integer the number can be (default: INT_MIN)
  * @param _max is the maximum integer the number can be (default: INT_MAX)
  * @return int of the number the user input
+ * @throws invalid_argument if input ends before a valid number
  */
 int utils::integer_input_throw(std::istream & in, const char * _err_msg, int _min, int _max) const
 {
@@ -68,6 +78,8 @@ int utils::integer_input_throw(std::istream & in, const char * _err_msg, int _mi
     in >> number;
     while (in.fail() || number < _min || number > _max)
     {
+        if (in.eof())
+            throw invalid_argument("Input ended.");
         in.clear();
         in.ignore(10000, '\n');
         if (_err_msg)
@@ -84,11 +96,14 @@ int utils::integer_input_throw(std::istream & in, const char * _err_msg, int _mi
  * NOTE: Does not clear stream of excess characters
  * @param in is the input stream
  * @return char: is the uppercase character
+ * @throws invalid_argument if input ends
  */
 char utils::capital_char_input(std::istream & in) const
 {
     char option;
     in >> option;
+    if (!in)
+        throw invalid_argument("Input ended.");
     return toupper(option);
 }
 
@@ -151,8 +166,9 @@ char utils::y_n_input(std::istream & in, const char * _msg) const
  * @brief Reads in name of file to save bracket as with error checking
  * 
  * @param _output_file is the file name to save into (is updated in method)
+ * @param _extension is added to the end of the name (default: .txt)
  */
-void utils::read_output_file(string & _output_file) const
+void utils::read_output_file(string & _output_file, const char * _extension) const
 {
     cout << "What would you like to save the file as? " << endl
          << "-> ";
@@ -167,28 +183,7 @@ void utils::read_output_file(string & _output_file) const
         getline(cin, _output_file);
     }
 
-    _output_file.append(".txt");
-}
-
-
-/**
- * @brief Fills a vector of strings with all entries in a directory
- * 
- * @param _files is a std::vector<std::string> to fill with directory entries 
- *               (must be empty)
- * @param _path is a string path to directory to get entries of
- */
-void utils::get_files(vector<string> & _files, const string & _path) const
-{
-    if (_files.size() > 0)
-        throw invalid_argument("Vector argument is non-empty");
-    // Get all files in directory
-    for (const auto & entry : filesystem::directory_iterator(_path))
-        _files.push_back(entry.path().filename().string());
-    
-    // Throw error if empty directory
-    if (_files.size() < 1)
-        throw invalid_argument("No files in the selection, please try adding one to resources\\new.");
+    _output_file.append(_extension);
 }
 
 
@@ -202,20 +197,104 @@ void utils::get_files(vector<string> & _files, const string & _path) const
  */
 bool utils::check_file_exists(const string & _output_file, const char * _path) const
 {
-    vector<string> reserved_files;  // Files in resources/saved
-
     if (!_path)
         throw invalid_argument("Path must be non-null");
-    // resources/saved can be a size of 0, so ignore the throw
-    try {
-        this->get_files(reserved_files, _path);
-    } catch (...) {}
+    // Look the name up directly instead of listing the directory
+    error_code err;
+    return filesystem::exists(filesystem::path(_path) / _output_file, err);
+}
+
+
+/**
+ * @brief Hashes a buffer with 64-bit FNV-1a. Used to detect saved files that
+ *        were cut short or corrupted.
+ * 
+ * @param _bytes is the start of the buffer
+ * @param _size is the number of bytes to hash
+ * @return uint64_t: the hash of the buffer
+ */
+uint64_t utils::checksum(const char * _bytes, size_t _size) const
+{
+    uint64_t hash = 14695981039346656037ull;    // FNV offset basis
+
+    for (size_t i = 0; i < _size; ++i)
+    {
+        hash ^= (unsigned char)_bytes[i];
+        hash *= 1099511628211ull;               // FNV prime
+    }
+    return hash;
+}
+
+/**
+ * @brief counts the set bits of a word by summing bits in parallel, two bits
+ *        at a time, then four, then eight, then every byte at once
+ * 
+ * @param _bits is the word to count the bits of
+ * @return the number of bits set in _bits
+ */
+int utils::popcount(uint64_t _bits) const
+{
+    _bits = _bits - ((_bits >> 1) & 0x5555555555555555ull);
+    _bits = (_bits & 0x3333333333333333ull) + ((_bits >> 2) & 0x3333333333333333ull);
+    _bits = (_bits + (_bits >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (_bits * 0x0101010101010101ull) >> 56;
+}
+
+
+/**
+ * @brief Finds the index of the highest set bit of a number with shifts, so
+ *        the log of a power of two is exact for any 64-bit size (unlike a
+ *        floating point log2() cast to an int).
+ * 
+ * @param _num is the number to take the log of
+ * @return int: floor(log2(_num)), or 0 if _num is 0
+ */
+int utils::floor_log2(uint64_t _num) const
+{
+    int bit = 0;    // Highest set bit found so far
 
-    // If the file name exists, return that it exists
-    for (int i = 0; i < (int)reserved_files.size(); ++i)
+    for (int step = 32; step > 0; step /= 2)
     {
-        if (reserved_files[i] == _output_file)
-            return true;
+        if (_num >> step)
+        {
+            _num >>= step;
+            bit   += step;
+        }
     }
-    return false;
-}
\ No newline at end of file
+    return bit;
+}
+
+
+/**
+ * @brief Forces every byte written to a file so far onto the disk, not just to
+ *        the operating system, with FlushFileBuffers() on Windows and fsync()
+ *        elsewhere. Bytes written through a stream must be flushed first.
+ * 
+ * @param _file_name is the file to sync
+ * @return true if the file is on disk
+ * @return false if it couldn't be opened or synced
+ */
+bool utils::sync_file(const string & _file_name) const
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(_file_name.c_str(), GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    bool   synced;
+
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    synced = FlushFileBuffers(file);
+    CloseHandle(file);
+    return synced;
+#else
+    int  file = open(_file_name.c_str(), O_RDWR);
+    bool synced;
+
+    if (file < 0)
+        return false;
+    synced = fsync(file) == 0;
+    close(file);
+    return synced;
+#endif
+}
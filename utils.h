@@ -11,9 +11,11 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <climits>
 #include <vector>
 #include <string>
 #include <filesystem>
+#include <cstdint>
 
 /**
  * @brief Holds utility methods for testing if an int is a power of two, getting
@@ -34,9 +36,16 @@ class utils
         bool are_you_sure(std::istream & in, const char * _msg = nullptr, bool print_newline = false) const;
         // Gets Y or N input
         char y_n_input(std::istream & in, const char * _msg = nullptr) const;
-        void read_output_file(std::string &) const;
-        void get_files(std::vector<std::string> &, const std::string &) const;
+        void read_output_file(std::string &, const char * _extension = ".txt") const;
         bool check_file_exists(const std::string &, const char *) const;
+        // 64-bit FNV-1a hash of a buffer, used to checksum saved files
+        std::uint64_t checksum(const char * _bytes, std::size_t _size) const;
+        // Number of set bits in a 64-bit word
+        int  popcount(std::uint64_t _bits) const;
+        // Index of the highest set bit, so floor(log2()) exactly (0 for 0)
+        int  floor_log2(std::uint64_t _num) const;
+        // Forces the bytes written to a file onto the disk
+        bool sync_file(const std::string & _file_name) const;
 };
 
 #endif
\ No newline at end of file